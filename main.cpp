@@ -2,6 +2,7 @@
 #include "qcustomplot.h"
 #include <QApplication>
 #include <QMainWindow>
+#include <QScreen>
 #include <QSvgGenerator>
 #include <tuple>
 
@@ -24,6 +25,13 @@ std::tuple<AxisData, AxisData> plotData()
     return { x, y };
 }
 
+QSharedPointer<QCPDataColumn> makeColumn(const AxisData& data)
+{
+    // столбец читает данные прямо из буфера, без копирования в QCPGraphDataContainer;
+    // копия вектора служит "владельцем" буфера (QVector разделяется неявно)
+    return QSharedPointer<QCPDataColumn>(new QCPBufferColumn(data.constData(), data.size(), data));
+}
+
 void generateReport(QTextCursor& cursor, QCustomPlot* cp)
 {
     {
@@ -94,6 +102,16 @@ int main(int argc, char* argv[])
 
     auto cp = new QCustomPlot(&window);
     graphicslayout->addWidget(cp);
+    // перерисовки чаще частоты обновления экрана всё равно не видны, объединяем их
+    cp->setMaximumFrameRate(QGuiApplication::primaryScreen()->refreshRate());
+    // растеризация слоёв в фоновом потоке, чтобы интерфейс не подвисал на больших данных
+    cp->setBackgroundRendering(true);
+    // при панорамировании раскладка обычно не меняется, пересчитываем её только при необходимости
+    cp->setPlottingHint(QCP::phSkipUnchangedLayout);
+    // перерисовываем только изменившиеся слои, иначе replotOverlay() перерисует весь график
+    cp->setPlottingHint(QCP::phSkipCleanLayers);
+    // прореживание миллионов точек графика распределяем по потокам
+    cp->setPlottingHint(QCP::phParallelSampling);
     cp->plotLayout()->clear();
 
     auto saveSvgButton = new QPushButton("Save as SVG");
@@ -120,6 +138,9 @@ int main(int argc, char* argv[])
     // получаем данные для графиков
     const auto [x, y] = plotData();
 
+    // оба графика используют один общий столбец ключей
+    const auto keyColumn = makeColumn(x);
+
     // "верхний" график
     QCPGraph* topGraph{};
     {
@@ -131,7 +152,7 @@ int main(int argc, char* argv[])
         topGraph =
             cp->addGraph(topAxisRect->axis(QCPAxis::atBottom), topAxisRect->axis(QCPAxis::atLeft));
 
-        topGraph->setData(x, y);
+        topGraph->setData(keyColumn, makeColumn(y));
         topGraph->rescaleAxes();
     }
 
@@ -145,7 +166,7 @@ int main(int argc, char* argv[])
         auto bottomGraph = cp->addGraph(
             bottomAxisRect->axis(QCPAxis::atBottom), bottomAxisRect->axis(QCPAxis::atLeft));
 
-        bottomGraph->setData(x, y);
+        bottomGraph->setData(keyColumn, makeColumn(y));
         bottomGraph->rescaleAxes();
     }
 
@@ -178,7 +199,12 @@ int main(int argc, char* argv[])
                 endLine->point1->setPixelPosition(pos);
                 endLine->point2->setPixelPosition(pos + upVector);
 
-                cp->replot();
+                // Линии выделения рисуются на отдельном буферизованном слое,
+                // чтобы при их перемещении не перерисовывать графики
+                cp->moveToOverlay(startLine);
+                cp->moveToOverlay(endLine);
+
+                cp->replotOverlay();
             }
         }
     });
@@ -240,7 +266,7 @@ int main(int argc, char* argv[])
             endLine->point1->setPixelPosition(event->pos());
             endLine->point2->setPixelPosition(event->pos() + upVector);
 
-            cp->replot();
+            cp->replotOverlay();
         }
     });
 
@@ -261,9 +287,9 @@ int main(int argc, char* argv[])
 
             if (axisRect == currentAxisRect)
                 axisRect->axis(QCPAxis::atLeft)->scaleRange(factor);
-
-            cp->replot();
         }
+
+        cp->replot();
     });
 
     QObject::connect(saveSvgButton, &QPushButton::pressed, [&]() {
@@ -371,7 +397,7 @@ int main(int argc, char* argv[])
                 topGraph = cp->addGraph(
                     topAxisRect->axis(QCPAxis::atBottom), topAxisRect->axis(QCPAxis::atLeft));
 
-                topGraph->setData(x, y);
+                topGraph->setData(keyColumn, makeColumn(y));
                 topGraph->rescaleAxes();
             }
         }
@@ -638,6 +638,98 @@ void QCPAbstractPaintBuffer::setDevicePixelRatio(double ratio)
   }
 }
 
+/*!
+  Draws only the part \a rect (in logical coordinates) of this buffer with \a painter, at the same
+  position. This is used by QCustomPlot's paint event to blit only the damaged region of the widget.
+  
+  The default implementation draws the entire buffer with \ref draw, relying on the clipping of \a
+  painter.
+*/
+void QCPAbstractPaintBuffer::drawPart(QCPPainter *painter, const QRect &rect) const
+{
+  Q_UNUSED(rect)
+  draw(painter);
+}
+
+/*!
+  Replaces the content of this buffer with \a image, which must be at least as large as this buffer
+  multiplied with its device pixel ratio. Only the top left part of \a image is used, so images
+  from an over-allocated pool (see \ref allocationSize) can be passed.
+
+  This is used to hand over content that was rasterized in another thread (see \ref
+  QCPPaintBufferRenderTask). The default implementation clears the buffer, draws \a image onto it
+  and keeps \a image for the next rasterization of this buffer (see \ref takeSpareImage).
+  Subclasses which are based on QImage may adopt \a image without copying the pixels.
+*/
+void QCPAbstractPaintBuffer::setImage(const QImage &image)
+{
+  clear(Qt::transparent);
+  if (QCPPainter *painter = startPainting())
+  {
+    painter->drawImage(QPointF(0, 0), image, QRectF(QPointF(0, 0), QSizeF(mSize*mDevicePixelRatio)));
+    delete painter;
+    donePainting();
+  }
+  recycleImage(image);
+}
+
+/*! \internal
+  
+  Returns the size in device pixels that a subclass should allocate in \ref reallocateBuffer, given
+  the currently allocated size \a allocatedSize and the required size \a requiredSize (the buffer
+  size multiplied with the device pixel ratio).
+  
+  To avoid reallocations on every step of an interactive resize, allocations are rounded up to
+  multiples of 256 pixels, and an existing allocation is kept as long as the required size fits into
+  it without wasting more than two such steps in either dimension. Subclasses then only use the top
+  left part of their allocation.
+*/
+QSize QCPAbstractPaintBuffer::allocationSize(const QSize &allocatedSize, const QSize &requiredSize)
+{
+  const int step = 256;
+  if (requiredSize.width() <= allocatedSize.width() && requiredSize.height() <= allocatedSize.height() &&
+      allocatedSize.width()-requiredSize.width() <= 2*step && allocatedSize.height()-requiredSize.height() <= 2*step)
+    return allocatedSize;
+  return QSize((requiredSize.width()+step-1)/step*step, (requiredSize.height()+step-1)/step*step);
+}
+
+/*! \internal
+  
+  Returns an image from the spare images of this buffer that can hold \a pixelSize device pixels
+  without being reallocated (see \ref allocationSize), and removes it from the spare images. If no
+  spare image fits, returns a null image.
+  
+  The spare images are images that were handed to this buffer by \ref QCPPaintBufferRenderTask and
+  aren't used anymore (see \ref recycleImage). Rasterizing into them instead of new images avoids
+  allocating full-size images on every replot while background or parallel rendering is enabled.
+*/
+QImage QCPAbstractPaintBuffer::takeSpareImage(const QSize &pixelSize)
+{
+  for (int i=0; i<mSpareImages.size(); ++i)
+  {
+    if (allocationSize(mSpareImages.at(i).size(), pixelSize) == mSpareImages.at(i).size())
+      return mSpareImages.takeAt(i);
+  }
+  return QImage();
+}
+
+/*! \internal
+  
+  Adds \a image to the spare images of this buffer, which can be reused with \ref takeSpareImage.
+  Only the most recent few images are kept.
+  
+  The caller must not keep other references to \a image, otherwise the next rasterization into it
+  would have to copy it first.
+*/
+void QCPAbstractPaintBuffer::recycleImage(const QImage &image)
+{
+  if (image.isNull())
+    return;
+  mSpareImages.append(image);
+  while (mSpareImages.size() > spareImageCount)
+    mSpareImages.removeFirst();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPPaintBufferPixmap
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -675,8 +767,26 @@ QCPPainter *QCPPaintBufferPixmap::startPainting()
 void QCPPaintBufferPixmap::draw(QCPPainter *painter) const
 {
   if (painter && painter->isActive())
-    painter->drawPixmap(0, 0, mBuffer);
-  else
+  {
+    const QSize pixelSize = mSize*mDevicePixelRatio;
+    if (mBuffer.size() == pixelSize)
+      painter->drawPixmap(0, 0, mBuffer);
+    else // only the top left part of the allocation is used, see reallocateBuffer
+      painter->drawPixmap(QPointF(0, 0), mBuffer, QRectF(QPointF(0, 0), QSizeF(pixelSize)));
+  } else
+    qDebug() << Q_FUNC_INFO << "invalid or inactive painter passed";
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferPixmap::drawPart(QCPPainter *painter, const QRect &rect) const
+{
+  if (painter && painter->isActive())
+  {
+    const QRect targetRect = rect & QRect(QPoint(0, 0), mSize);
+    if (!targetRect.isEmpty())
+      painter->drawPixmap(QRectF(targetRect), mBuffer, QRectF(targetRect.x()*mDevicePixelRatio, targetRect.y()*mDevicePixelRatio,
+                                                              targetRect.width()*mDevicePixelRatio, targetRect.height()*mDevicePixelRatio));
+  } else
     qDebug() << Q_FUNC_INFO << "invalid or inactive painter passed";
 }
 
@@ -690,19 +800,359 @@ void QCPPaintBufferPixmap::clear(const QColor &color)
 void QCPPaintBufferPixmap::reallocateBuffer()
 {
   setInvalidated();
+#ifndef QCP_DEVICEPIXELRATIO_SUPPORTED
   if (!qFuzzyCompare(1.0, mDevicePixelRatio))
   {
+    qDebug() << Q_FUNC_INFO << "Device pixel ratios not supported for Qt versions before 5.4";
+    mDevicePixelRatio = 1.0;
+  }
+#endif
+  // keep the allocation if the new size fits, so interactive resizing doesn't reallocate on every step:
+  const QSize allocation = allocationSize(mBuffer.size(), mSize*mDevicePixelRatio);
+  if (allocation != mBuffer.size())
+    mBuffer = QPixmap(allocation);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  mBuffer.setDevicePixelRatio(mDevicePixelRatio);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPaintBufferImage
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPaintBufferImage
+  \brief A paint buffer based on QImage, using software raster rendering
+
+  Unlike QPixmap, QImage may be painted on in threads other than the GUI thread, and without a
+  windowing system. This paint buffer is used if \ref QCustomPlot::setPaintBufferType is set to
+  \ref QCustomPlot::pbtImage, or if \ref QCustomPlot::setBackgroundRendering is enabled. In the
+  latter case, the layers are then rasterized
+  into separate images by worker threads (see \ref QCPPaintBufferRenderTask), which are adopted by
+  the buffer with \ref setImage once they are finished. The previously adopted image is kept as
+  spare image, so the next rasterization reuses its allocation.
+*/
+
+/*!
+  Creates an image paint buffer instance with the specified \a size and \a devicePixelRatio, if
+  applicable.
+*/
+QCPPaintBufferImage::QCPPaintBufferImage(const QSize &size, double devicePixelRatio) :
+  QCPAbstractPaintBuffer(size, devicePixelRatio)
+{
+  QCPPaintBufferImage::reallocateBuffer();
+}
+
+QCPPaintBufferImage::~QCPPaintBufferImage()
+{
+}
+
+/*!
+  Returns the current content of this buffer. The image has the size of the buffer multiplied with
+  its device pixel ratio.
+*/
+QImage QCPPaintBufferImage::image() const
+{
+  const QSize pixelSize = mSize*mDevicePixelRatio;
+  if (mBuffer.size() == pixelSize)
+    return mBuffer;
+  else // only the top left part of the allocation is used, see reallocateBuffer
+    return mBuffer.copy(QRect(QPoint(0, 0), pixelSize));
+}
+
+/*!
+  Adopts \a image as the content of this buffer, without copying the pixels. The image must be at
+  least as large as this buffer multiplied with its device pixel ratio, and have the same device
+  pixel ratio, otherwise it is ignored. Like the buffer's own allocation, only the top left part of
+  \a image is used.
+  
+  The previous image of this buffer is kept as spare image for the next rasterization (see \ref
+  takeSpareImage).
+*/
+void QCPPaintBufferImage::setImage(const QImage &image)
+{
+  const QSize pixelSize = mSize*mDevicePixelRatio;
 #ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
-    mBuffer = QPixmap(mSize*mDevicePixelRatio);
-    mBuffer.setDevicePixelRatio(mDevicePixelRatio);
+  if (image.width() < pixelSize.width() || image.height() < pixelSize.height() || !qFuzzyCompare(image.devicePixelRatio(), mDevicePixelRatio))
 #else
+  if (image.width() < pixelSize.width() || image.height() < pixelSize.height())
+#endif
+  {
+    qDebug() << Q_FUNC_INFO << "image doesn't match buffer size and device pixel ratio";
+    return;
+  }
+  recycleImage(mBuffer);
+  mBuffer = image;
+}
+
+/* inherits documentation from base class */
+QCPPainter *QCPPaintBufferImage::startPainting()
+{
+  QCPPainter *result = new QCPPainter(&mBuffer);
+  result->setRenderHint(QPainter::HighQualityAntialiasing);
+  return result;
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::draw(QCPPainter *painter) const
+{
+  if (painter && painter->isActive())
+  {
+    const QSize pixelSize = mSize*mDevicePixelRatio;
+    if (mBuffer.size() == pixelSize)
+      painter->drawImage(0, 0, mBuffer);
+    else // only the top left part of the allocation is used, see reallocateBuffer
+      painter->drawImage(QPointF(0, 0), mBuffer, QRectF(QPointF(0, 0), QSizeF(pixelSize)));
+  } else
+    qDebug() << Q_FUNC_INFO << "invalid or inactive painter passed";
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::drawPart(QCPPainter *painter, const QRect &rect) const
+{
+  if (painter && painter->isActive())
+  {
+    const QRect targetRect = rect & QRect(QPoint(0, 0), mSize);
+    if (!targetRect.isEmpty())
+      painter->drawImage(QRectF(targetRect), mBuffer, QRectF(targetRect.x()*mDevicePixelRatio, targetRect.y()*mDevicePixelRatio,
+                                                             targetRect.width()*mDevicePixelRatio, targetRect.height()*mDevicePixelRatio));
+  } else
+    qDebug() << Q_FUNC_INFO << "invalid or inactive painter passed";
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::clear(const QColor &color)
+{
+  mBuffer.fill(color);
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::reallocateBuffer()
+{
+  setInvalidated();
+#ifndef QCP_DEVICEPIXELRATIO_SUPPORTED
+  if (!qFuzzyCompare(1.0, mDevicePixelRatio))
+  {
     qDebug() << Q_FUNC_INFO << "Device pixel ratios not supported for Qt versions before 5.4";
     mDevicePixelRatio = 1.0;
-    mBuffer = QPixmap(mSize);
+  }
 #endif
-  } else
+  // keep the allocation if the new size fits, so interactive resizing doesn't reallocate on every step:
+  const QSize allocation = allocationSize(mBuffer.size(), mSize*mDevicePixelRatio);
+  if (allocation != mBuffer.size())
+  {
+    mBuffer = QImage(allocation, QImage::Format_ARGB32_Premultiplied);
+    mBuffer.fill(Qt::transparent); // the buffer may be shown before the rendering of its new content is finished
+    mSpareImages.clear(); // spare images were sized for the previous allocation
+  }
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  mBuffer.setDevicePixelRatio(mDevicePixelRatio);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPaintBufferRenderTask
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPaintBufferRenderTask
+  \brief Rasterizes recorded layer content into images on a worker thread
+
+  This class is used by QCustomPlot when \ref QCustomPlot::setBackgroundRendering or one of the
+  plotting hints \ref QCP::phParallelLayers and \ref QCP::phParallelAxisRects is enabled. The GUI
+  thread records the content of each paint buffer into one or more QPicture instances (see \ref
+  addPicture), which are immutable snapshots of the drawing commands and don't reference the
+  plottables anymore. The expensive rasterization of these pictures into images then happens in
+  \ref run on a thread pool. When all images are finished, the slot passed to the constructor (if
+  any) is invoked via a queued connection, and the GUI thread hands the images to their paint
+  buffers with \ref applyImages.
+  
+  A picture may cover only a part of its paint buffer, e.g. the rect of an axis rect. Such
+  pictures are rasterized into images of that size and blitted into the buffer at the respective
+  position. Multiple pictures of the same buffer are composited in the order they were added.
+  
+  The images are taken from the spare images of the paint buffers where possible, and are returned
+  to them after they were handed over (see \ref QCPAbstractPaintBuffer::takeSpareImage). Like the
+  paint buffers, new images are over-allocated (see \ref QCPAbstractPaintBuffer::allocationSize),
+  so consecutive replots and the steps of an interactive resize don't allocate new images.
+  
+  The task doesn't delete itself after running (see QRunnable::setAutoDelete), its owner is
+  responsible for keeping it alive until the finished slot was invoked.
+*/
+
+/*!
+  Creates an empty task. When \ref run has finished, the slot or invokable method \a member
+  (without parameter list) of \a receiver is invoked via a queued connection. If \a receiver is
+  zero, no notification takes place, e.g. because the owner waits for the thread pool instead.
+*/
+QCPPaintBufferRenderTask::QCPPaintBufferRenderTask(QObject *receiver, const char *member) :
+  mReceiver(receiver),
+  mMember(member)
+{
+  setAutoDelete(false);
+}
+
+/*!
+  Adds the recorded content \a picture of \a buffer to this task. The picture is rasterized into an
+  image covering \a rect of the buffer, in the buffer's coordinates.
+  
+  The size and device pixel ratio of the rendered image are taken from \a buffer at the time of
+  this call. Must be called before the task is started.
+  
+  \see removePictures
+*/
+void QCPPaintBufferRenderTask::addPicture(const QSharedPointer<QCPAbstractPaintBuffer> &buffer, const QPicture &picture, const QRect &rect)
+{
+  BufferJob job;
+  job.buffer = buffer;
+  job.picture = picture;
+  job.rect = rect;
+  job.size = buffer->size();
+  job.devicePixelRatio = buffer->devicePixelRatio();
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  job.image = buffer->takeSpareImage(rect.size()*job.devicePixelRatio);
+#else
+  job.image = buffer->takeSpareImage(rect.size());
+#endif
+  mJobs.append(job);
+}
+
+/*!
+  Removes all pictures of \a buffer from this task. This is used to replace outdated content of a
+  buffer with a more recent recording, before the task is started.
+*/
+void QCPPaintBufferRenderTask::removePictures(const QSharedPointer<QCPAbstractPaintBuffer> &buffer)
+{
+  for (int i=mJobs.size()-1; i>=0; --i)
+  {
+    if (mJobs.at(i).buffer == buffer)
+      buffer->recycleImage(mJobs.takeAt(i).image);
+  }
+}
+
+/*!
+  Hands the rendered images to their paint buffers. Buffers that were resized in the meantime keep
+  their content, since a newer recording for them is underway.
+  
+  Must be called in the GUI thread after \ref run has finished.
+*/
+void QCPPaintBufferRenderTask::applyImages()
+{
+  applyJobs(mJobs);
+  releaseImages();
+}
+
+/*!
+  Rasterizes all pictures into images. This method doesn't access the paint buffers or any other
+  object of the plot, so it may be called in any thread.
+*/
+void QCPPaintBufferRenderTask::run()
+{
+  for (int i=0; i<mJobs.size(); ++i)
+  {
+    BufferJob &job = mJobs[i];
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    const QSize pixelSize = job.rect.size()*job.devicePixelRatio;
+#else
+    const QSize pixelSize = job.rect.size();
+#endif
+    // reuse the spare image taken in addPicture if there is one, else allocate with headroom for the next resize steps:
+    const QSize allocation = QCPAbstractPaintBuffer::allocationSize(job.image.size(), pixelSize);
+    if (allocation != job.image.size())
+      job.image = QImage(allocation, QImage::Format_ARGB32_Premultiplied);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    job.image.setDevicePixelRatio(job.devicePixelRatio);
+#endif
+    QCPPainter painter(&job.image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(QRect(QPoint(0, 0), job.rect.size()), Qt::transparent); // only the top left part of the image is used
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setRenderHint(QPainter::HighQualityAntialiasing);
+    painter.translate(-job.rect.topLeft());
+    painter.drawPicture(0, 0, job.picture);
+  }
+  // the owner may destroy this task as soon as the receiver was notified, so don't access members afterwards:
+  QObject *receiver = mReceiver;
+  const QByteArray member = mMember;
+  if (receiver)
+    QMetaObject::invokeMethod(receiver, member.constData(), Qt::QueuedConnection);
+}
+
+/*!
+  Hands the rendered images of all \a tasks to their paint buffers. Use this instead of calling
+  \ref applyImages on each task, if the pictures of one buffer were distributed over multiple tasks
+  for concurrent rasterization.
+  
+  Must be called in the GUI thread after all \a tasks have finished.
+*/
+void QCPPaintBufferRenderTask::applyImages(const QList<QSharedPointer<QCPPaintBufferRenderTask> > &tasks)
+{
+  QList<BufferJob> jobs;
+  for (int i=0; i<tasks.size(); ++i)
+    jobs << tasks.at(i)->mJobs;
+  applyJobs(jobs);
+  jobs.clear();
+  for (int i=0; i<tasks.size(); ++i)
+    tasks.at(i)->releaseImages();
+}
+
+/*! \internal
+  
+  Drops the references of this task to its rendered images after they were handed to the paint
+  buffers, so the buffers hold the only references and can rasterize into them again without
+  copying.
+*/
+void QCPPaintBufferRenderTask::releaseImages()
+{
+  for (int i=0; i<mJobs.size(); ++i)
+    mJobs[i].image = QImage();
+}
+
+/*! \internal
+  
+  Hands the rendered images of \a jobs to their paint buffers. If a buffer has a single image
+  covering the entire buffer, it's passed to \ref QCPAbstractPaintBuffer::setImage. Otherwise the
+  buffer is cleared and the images are blitted into it at their positions, in the order of \a jobs,
+  and then returned to the buffer as spare images.
+*/
+void QCPPaintBufferRenderTask::applyJobs(const QList<BufferJob> &jobs)
+{
+  QList<QCPAbstractPaintBuffer*> handledBuffers;
+  for (int i=0; i<jobs.size(); ++i)
   {
-    mBuffer = QPixmap(mSize);
+    QCPAbstractPaintBuffer *buffer = jobs.at(i).buffer.data();
+    if (handledBuffers.contains(buffer))
+      continue;
+    handledBuffers.append(buffer);
+    QList<int> bufferJobs;
+    for (int k=i; k<jobs.size(); ++k)
+    {
+      if (jobs.at(k).buffer.data() == buffer)
+        bufferJobs.append(k);
+    }
+    const BufferJob &first = jobs.at(i);
+    if (buffer->size() != first.size || !qFuzzyCompare(buffer->devicePixelRatio(), first.devicePixelRatio))
+      continue;
+    
+    if (bufferJobs.size() == 1 && first.rect == QRect(QPoint(0, 0), first.size))
+    {
+      buffer->setImage(first.image);
+    } else
+    {
+      buffer->clear(Qt::transparent);
+      if (QCPPainter *painter = buffer->startPainting())
+      {
+        for (int k=0; k<bufferJobs.size(); ++k)
+        {
+          const BufferJob &job = jobs.at(bufferJobs.at(k));
+          painter->drawImage(QRectF(job.rect), job.image, QRectF(QPointF(0, 0), QSizeF(job.rect.size()*job.devicePixelRatio))); // only the top left part of the image is used
+        }
+        delete painter;
+        buffer->donePainting();
+      }
+      for (int k=0; k<bufferJobs.size(); ++k)
+        buffer->recycleImage(jobs.at(bufferJobs.at(k)).image);
+    }
   }
 }
 
@@ -1011,6 +1461,20 @@ void QCPPaintBufferGlFbo::reallocateBuffer()
   compared with a full replot of all layers. Upon creation of a new layer, the layer mode is
   initialized to \ref lmLogical. The only layer that is set to \ref lmBuffered in a new \ref
   QCustomPlot instance is the "overlay" layer, containing the selection rect.
+  
+  Objects that change frequently during user interaction, e.g. items dragged with the mouse or
+  cursors following it, can be moved temporarily to the "overlay" layer with \ref
+  QCustomPlot::moveToOverlay. \ref QCustomPlot::replotOverlay then only redraws these objects, so
+  the cost of the interactive feedback doesn't depend on the amount of data in the plot.
+  
+  \section qcplayer-dirty Skipping unchanged layers
+  
+  If the plotting hint \ref QCP::phSkipCleanLayers is set, a full \ref QCustomPlot::replot only
+  redraws the paint buffers of layers that are dirty (see \ref markDirty). The other paint buffers
+  keep their content from the previous replot and are merely composited again. Logical layers that
+  share a paint buffer are redrawn together if any of them is dirty. So to benefit from this, layers
+  with expensive content that rarely changes (e.g. large plottables) and layers with frequently
+  changing content (e.g. a cursor item) should be separated by a layer in \ref lmBuffered mode.
 */
 
 /* start documentation of inline functions */
@@ -1029,6 +1493,33 @@ void QCPPaintBufferGlFbo::reallocateBuffer()
   Layers with higher indices will be drawn above layers with lower indices.
 */
 
+/*! \fn bool QCPLayer::dirty() const
+  
+  Returns whether this layer needs to be redrawn in the next replot. See \ref markDirty.
+*/
+
+/*! \fn void QCPLayer::markDirty()
+  
+  Marks this layer as needing to be redrawn in the next replot. This is only relevant if the
+  plotting hint \ref QCP::phSkipCleanLayers is set, see the \ref qcplayer-dirty "class
+  documentation". The entire viewport is repainted after the layer was redrawn, see \ref
+  markDirty(const QRect &rect) to restrict the repaint to a part of it.
+  
+  The following changes mark the affected layers dirty automatically: Adding or removing
+  layerables, changing the visibility or mode of layers, and calling the appearance setters of
+  layerables, i.e. the setters of plottables, items (including their positions), axes, grids,
+  legends, legend items, text elements, color scales and the selection rect. Moving an item also
+  marks the items anchored to it. Changes of axis ranges and scale types, the plot layout (e.g. the
+  setters of layout elements) or the viewport cause all layers to be redrawn.
+  
+  Changes to objects that are merely held by a layerable don't reach it, and require a call to this
+  method or to \ref QCPLayerable::markDirty. Examples are modifying the data of a plottable directly
+  via its data container, changing the properties of an axis ticker or a selection decorator, and
+  changing the data of a graph that a \ref QCPItemTracer is attached to.
+  
+  Layers become clean again when they were drawn by \ref QCustomPlot::replot or \ref replot.
+*/
+
 /* end documentation of inline functions */
 
 /*!
@@ -1045,7 +1536,8 @@ QCPLayer::QCPLayer(QCustomPlot *parentPlot, const QString &layerName) :
   mName(layerName),
   mIndex(-1), // will be set to a proper value by the QCustomPlot layer creation function
   mVisible(true),
-  mMode(lmLogical)
+  mMode(lmLogical),
+  mDirty(true)
 {
   // Note: no need to make sure layerName is unique, because layer
   // management is done with QCustomPlot functions.
@@ -1076,6 +1568,7 @@ QCPLayer::~QCPLayer()
 void QCPLayer::setVisible(bool visible)
 {
   mVisible = visible;
+  markDirty();
 }
 
 /*!
@@ -1106,9 +1599,43 @@ void QCPLayer::setMode(QCPLayer::LayerMode mode)
     mMode = mode;
     if (!mPaintBuffer.isNull())
       mPaintBuffer.data()->setInvalidated();
+    markDirty();
   }
 }
 
+/*! \overload
+  
+  Marks this layer as needing to be redrawn in the next replot, like \ref markDirty(), but only the
+  pixels inside \a rect have changed. If the plotting hint \ref QCP::phSkipCleanLayers is set, \ref
+  QCustomPlot::replot then repaints only the union of the changed rects of all dirty layers on the
+  widget, instead of the entire viewport.
+  
+  \ref QCPLayerable::markDirty uses this with the clip rect of the layerable, e.g. the axis rect
+  of a plottable.
+*/
+void QCPLayer::markDirty(const QRect &rect)
+{
+  if (!mDirty)
+  {
+    mDirty = true;
+    mDirtyRegion = rect;
+  } else if (!mDirtyRegion.isEmpty()) // an empty region of a dirty layer means the entire viewport is affected already
+    mDirtyRegion += rect;
+}
+
+/*! \internal
+  
+  Returns the region of the viewport that changed since this layer was last drawn, see \ref
+  markDirty. This is only meaningful if the layer is dirty.
+*/
+QRegion QCPLayer::dirtyRegion() const
+{
+  if (mDirtyRegion.isEmpty())
+    return QRegion(mParentPlot->viewport());
+  else
+    return mDirtyRegion & mParentPlot->viewport();
+}
+
 /*! \internal
 
   Draws the contents of this layer with the provided \a painter.
@@ -1120,16 +1647,28 @@ void QCPLayer::draw(QCPPainter *painter)
   foreach (QCPLayerable *child, mChildren)
   {
     if (child->realVisibility())
-    {
-      painter->save();
-      painter->setClipRect(child->clipRect().translated(0, -1));
-      child->applyDefaultAntialiasingHint(painter);
-      child->draw(painter);
-      painter->restore();
-    }
+      drawLayerable(painter, child);
   }
 }
 
+/*! \internal
+
+  Draws the single \a layerable with the provided \a painter, clipped to the layerable's \ref
+  QCPLayerable::clipRect and with its default antialiasing hint applied. The state of \a painter
+  is restored afterwards.
+  
+  This is used by \ref draw, and by QCustomPlot to record layerables for background and parallel
+  rendering, so both draw the layerables identically.
+*/
+void QCPLayer::drawLayerable(QCPPainter *painter, QCPLayerable *layerable)
+{
+  painter->save();
+  painter->setClipRect(layerable->clipRect().translated(0, -1));
+  layerable->applyDefaultAntialiasingHint(painter);
+  layerable->draw(painter);
+  painter->restore();
+}
+
 /*! \internal
 
   Draws the contents of this layer into the paint buffer which is associated with this layer. The
@@ -1175,10 +1714,21 @@ void QCPLayer::replot()
   {
     if (!mPaintBuffer.isNull())
     {
-      mPaintBuffer.data()->clear(Qt::transparent);
-      drawToPaintBuffer();
+      // with dirty tracking enabled, only the changed region of the widget needs to be repainted:
+      const QRegion damage = mDirty && mParentPlot->plottingHints().testFlag(QCP::phSkipCleanLayers) ? dirtyRegion() : QRegion(mParentPlot->viewport());
+      if (mParentPlot->renderingInBackground())
+      {
+        mParentPlot->queueBackgroundRendering(mPaintBuffer.toStrongRef());
+        mParentPlot->mPendingRenderDamage += damage;
+        mParentPlot->startBackgroundRendering();
+      } else
+      {
+        mPaintBuffer.data()->clear(Qt::transparent);
+        drawToPaintBuffer();
+        mParentPlot->update(damage);
+      }
       mPaintBuffer.data()->setInvalidated(false);
-      mParentPlot->update();
+      markClean();
     } else
       qDebug() << Q_FUNC_INFO << "no valid paint buffer associated with this layer";
   } else if (mMode == lmLogical)
@@ -1205,6 +1755,7 @@ void QCPLayer::addChild(QCPLayerable *layerable, bool prepend)
       mChildren.append(layerable);
     if (!mPaintBuffer.isNull())
       mPaintBuffer.data()->setInvalidated();
+    markDirty();
   } else
     qDebug() << Q_FUNC_INFO << "layerable is already child of this layer" << reinterpret_cast<quintptr>(layerable);
 }
@@ -1224,6 +1775,7 @@ void QCPLayer::removeChild(QCPLayerable *layerable)
   {
     if (!mPaintBuffer.isNull())
       mPaintBuffer.data()->setInvalidated();
+    markDirty();
   } else
     qDebug() << Q_FUNC_INFO << "layerable is not child of this layer" << reinterpret_cast<quintptr>(layerable);
 }
@@ -1370,6 +1922,7 @@ QCPLayerable::~QCPLayerable()
 void QCPLayerable::setVisible(bool on)
 {
   mVisible = on;
+  markDirty();
 }
 
 /*!
@@ -1417,6 +1970,7 @@ bool QCPLayerable::setLayer(const QString &layerName)
 void QCPLayerable::setAntialiased(bool enabled)
 {
   mAntialiased = enabled;
+  markDirty();
 }
 
 /*!
@@ -1435,10 +1989,30 @@ bool QCPLayerable::realVisibility() const
 }
 
 /*!
-  This function is used to decide whether a click hits a layerable object or not.
-
-  \a pos is a point in pixel coordinates on the QCustomPlot surface. This function returns the
-  shortest pixel distance of this point to the object. If the object is either invisible or the
+  Marks the layer of this layerable as dirty, i.e. as needing to be redrawn in the next replot.
+  
+  This is only relevant if the plotting hint \ref QCP::phSkipCleanLayers is set. In that case,
+  \ref QCustomPlot::replot skips the layers whose appearance hasn't changed since the last replot.
+  Many changes mark the layer dirty automatically, see \ref QCPLayer::markDirty. Call this method
+  after any other change that affects the appearance of this layerable, for example after modifying
+  the data of a plottable via its data container directly.
+  
+  Only the \ref clipRect of this layerable is marked as changed (see \ref QCPLayer::markDirty(const
+  QRect &rect)), so changes that move the clip rect must call this method before and after the
+  change. Subclasses that are also drawn elsewhere reimplement this method to mark those regions as
+  well, e.g. \ref QCPAbstractPlottable::markDirty marks the legend items of the plottable.
+*/
+void QCPLayerable::markDirty()
+{
+  if (mLayer)
+    mLayer->markDirty(clipRect().translated(0, -1)); // same offset as the clipping in QCPLayer::drawLayerable
+}
+
+/*!
+  This function is used to decide whether a click hits a layerable object or not.
+
+  \a pos is a point in pixel coordinates on the QCustomPlot surface. This function returns the
+  shortest pixel distance of this point to the object. If the object is either invisible or the
   distance couldn't be determined, -1.0 is returned. Further, if \a onlySelectable is true and the
   object is not selectable, -1.0 is returned, too.
 
@@ -2856,6 +3430,7 @@ QCPRange QCPSelectionRect::range(const QCPAxis *axis) const
 void QCPSelectionRect::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -2867,6 +3442,7 @@ void QCPSelectionRect::setPen(const QPen &pen)
 void QCPSelectionRect::setBrush(const QBrush &brush)
 {
   mBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -2878,6 +3454,7 @@ void QCPSelectionRect::cancel()
   if (mActive)
   {
     mActive = false;
+    markDirty();
     emit canceled(mRect, 0);
   }
 }
@@ -2892,6 +3469,7 @@ void QCPSelectionRect::startSelection(QMouseEvent *event)
 {
   mActive = true;
   mRect = QRect(event->pos(), event->pos());
+  markDirty();
   emit started(event);
 }
 
@@ -2904,6 +3482,7 @@ void QCPSelectionRect::startSelection(QMouseEvent *event)
 void QCPSelectionRect::moveSelection(QMouseEvent *event)
 {
   mRect.setBottomRight(event->pos());
+  markDirty();
   emit changed(mRect, event);
   layer()->replot();
 }
@@ -2918,6 +3497,7 @@ void QCPSelectionRect::endSelection(QMouseEvent *event)
 {
   mRect.setBottomRight(event->pos());
   mActive = false;
+  markDirty();
   emit accepted(mRect, event);
 }
 
@@ -7188,6 +7768,7 @@ QCPGrid::QCPGrid(QCPAxis *parentAxis) :
 void QCPGrid::setSubGridVisible(bool visible)
 {
   mSubGridVisible = visible;
+  markDirty();
 }
 
 /*!
@@ -7196,6 +7777,7 @@ void QCPGrid::setSubGridVisible(bool visible)
 void QCPGrid::setAntialiasedSubGrid(bool enabled)
 {
   mAntialiasedSubGrid = enabled;
+  markDirty();
 }
 
 /*!
@@ -7204,6 +7786,7 @@ void QCPGrid::setAntialiasedSubGrid(bool enabled)
 void QCPGrid::setAntialiasedZeroLine(bool enabled)
 {
   mAntialiasedZeroLine = enabled;
+  markDirty();
 }
 
 /*!
@@ -7212,6 +7795,7 @@ void QCPGrid::setAntialiasedZeroLine(bool enabled)
 void QCPGrid::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -7220,6 +7804,7 @@ void QCPGrid::setPen(const QPen &pen)
 void QCPGrid::setSubGridPen(const QPen &pen)
 {
   mSubGridPen = pen;
+  markDirty();
 }
 
 /*!
@@ -7231,6 +7816,7 @@ void QCPGrid::setSubGridPen(const QPen &pen)
 void QCPGrid::setZeroLinePen(const QPen &pen)
 {
   mZeroLinePen = pen;
+  markDirty();
 }
 
 /*! \internal
@@ -7750,6 +8336,7 @@ void QCPAxis::setSelectedParts(const SelectableParts &selected)
     mSelectedParts = selected;
     emit selectionChanged(mSelectedParts);
   }
+  markDirty();
 }
 
 /*!
@@ -7880,6 +8467,7 @@ void QCPAxis::setTicker(QSharedPointer<QCPAxisTicker> ticker)
   else
     qDebug() << Q_FUNC_INFO << "can not set 0 as axis ticker";
   // no need to invalidate margin cache here because produced tick labels are checked for changes in setupTickVector
+  markDirty();
 }
 
 /*!
@@ -7897,6 +8485,7 @@ void QCPAxis::setTicks(bool show)
     mTicks = show;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -7911,6 +8500,7 @@ void QCPAxis::setTickLabels(bool show)
     if (!mTickLabels)
       mTickVectorLabels.clear();
   }
+  markDirty();
 }
 
 /*!
@@ -7924,6 +8514,7 @@ void QCPAxis::setTickLabelPadding(int padding)
     mAxisPainter->tickLabelPadding = padding;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -7938,6 +8529,7 @@ void QCPAxis::setTickLabelFont(const QFont &font)
     mTickLabelFont = font;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -7948,6 +8540,7 @@ void QCPAxis::setTickLabelFont(const QFont &font)
 void QCPAxis::setTickLabelColor(const QColor &color)
 {
   mTickLabelColor = color;
+  markDirty();
 }
 
 /*!
@@ -7966,6 +8559,7 @@ void QCPAxis::setTickLabelRotation(double degrees)
     mAxisPainter->tickLabelRotation = qBound(-90.0, degrees, 90.0);
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -7979,6 +8573,7 @@ void QCPAxis::setTickLabelSide(LabelSide side)
 {
   mAxisPainter->tickLabelSide = side;
   mCachedMarginValid = false;
+  markDirty();
 }
 
 /*!
@@ -8019,6 +8614,7 @@ void QCPAxis::setNumberFormat(const QString &formatCode)
     return;
   }
   mCachedMarginValid = false;
+  markDirty();
   
   // interpret first char as number format char:
   QString allowedFormatChars(QLatin1String("eEfgG"));
@@ -8078,6 +8674,7 @@ void QCPAxis::setNumberPrecision(int precision)
     mNumberPrecision = precision;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -8092,6 +8689,7 @@ void QCPAxis::setTickLength(int inside, int outside)
 {
   setTickLengthIn(inside);
   setTickLengthOut(outside);
+  markDirty();
 }
 
 /*!
@@ -8106,6 +8704,7 @@ void QCPAxis::setTickLengthIn(int inside)
   {
     mAxisPainter->tickLengthIn = inside;
   }
+  markDirty();
 }
 
 /*!
@@ -8122,6 +8721,7 @@ void QCPAxis::setTickLengthOut(int outside)
     mAxisPainter->tickLengthOut = outside;
     mCachedMarginValid = false; // only outside tick length can change margin
   }
+  markDirty();
 }
 
 /*!
@@ -8138,6 +8738,7 @@ void QCPAxis::setSubTicks(bool show)
     mSubTicks = show;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -8152,6 +8753,7 @@ void QCPAxis::setSubTickLength(int inside, int outside)
 {
   setSubTickLengthIn(inside);
   setSubTickLengthOut(outside);
+  markDirty();
 }
 
 /*!
@@ -8166,6 +8768,7 @@ void QCPAxis::setSubTickLengthIn(int inside)
   {
     mAxisPainter->subTickLengthIn = inside;
   }
+  markDirty();
 }
 
 /*!
@@ -8182,6 +8785,7 @@ void QCPAxis::setSubTickLengthOut(int outside)
     mAxisPainter->subTickLengthOut = outside;
     mCachedMarginValid = false; // only outside tick length can change margin
   }
+  markDirty();
 }
 
 /*!
@@ -8192,6 +8796,7 @@ void QCPAxis::setSubTickLengthOut(int outside)
 void QCPAxis::setBasePen(const QPen &pen)
 {
   mBasePen = pen;
+  markDirty();
 }
 
 /*!
@@ -8202,6 +8807,7 @@ void QCPAxis::setBasePen(const QPen &pen)
 void QCPAxis::setTickPen(const QPen &pen)
 {
   mTickPen = pen;
+  markDirty();
 }
 
 /*!
@@ -8212,6 +8818,7 @@ void QCPAxis::setTickPen(const QPen &pen)
 void QCPAxis::setSubTickPen(const QPen &pen)
 {
   mSubTickPen = pen;
+  markDirty();
 }
 
 /*!
@@ -8226,6 +8833,7 @@ void QCPAxis::setLabelFont(const QFont &font)
     mLabelFont = font;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -8236,6 +8844,7 @@ void QCPAxis::setLabelFont(const QFont &font)
 void QCPAxis::setLabelColor(const QColor &color)
 {
   mLabelColor = color;
+  markDirty();
 }
 
 /*!
@@ -8249,6 +8858,7 @@ void QCPAxis::setLabel(const QString &str)
     mLabel = str;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -8263,6 +8873,7 @@ void QCPAxis::setLabelPadding(int padding)
     mAxisPainter->labelPadding = padding;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -8282,6 +8893,7 @@ void QCPAxis::setPadding(int padding)
     mPadding = padding;
     mCachedMarginValid = false;
   }
+  markDirty();
 }
 
 /*!
@@ -8309,6 +8921,7 @@ void QCPAxis::setSelectedTickLabelFont(const QFont &font)
     mSelectedTickLabelFont = font;
     // don't set mCachedMarginValid to false here because margin calculation is always done with non-selected fonts
   }
+  markDirty();
 }
 
 /*!
@@ -8320,6 +8933,7 @@ void QCPAxis::setSelectedLabelFont(const QFont &font)
 {
   mSelectedLabelFont = font;
   // don't set mCachedMarginValid to false here because margin calculation is always done with non-selected fonts
+  markDirty();
 }
 
 /*!
@@ -8333,6 +8947,7 @@ void QCPAxis::setSelectedTickLabelColor(const QColor &color)
   {
     mSelectedTickLabelColor = color;
   }
+  markDirty();
 }
 
 /*!
@@ -8343,6 +8958,7 @@ void QCPAxis::setSelectedTickLabelColor(const QColor &color)
 void QCPAxis::setSelectedLabelColor(const QColor &color)
 {
   mSelectedLabelColor = color;
+  markDirty();
 }
 
 /*!
@@ -8353,6 +8969,7 @@ void QCPAxis::setSelectedLabelColor(const QColor &color)
 void QCPAxis::setSelectedBasePen(const QPen &pen)
 {
   mSelectedBasePen = pen;
+  markDirty();
 }
 
 /*!
@@ -8363,6 +8980,7 @@ void QCPAxis::setSelectedBasePen(const QPen &pen)
 void QCPAxis::setSelectedTickPen(const QPen &pen)
 {
   mSelectedTickPen = pen;
+  markDirty();
 }
 
 /*!
@@ -8373,6 +8991,7 @@ void QCPAxis::setSelectedTickPen(const QPen &pen)
 void QCPAxis::setSelectedSubTickPen(const QPen &pen)
 {
   mSelectedSubTickPen = pen;
+  markDirty();
 }
 
 /*!
@@ -8388,6 +9007,7 @@ void QCPAxis::setSelectedSubTickPen(const QPen &pen)
 void QCPAxis::setLowerEnding(const QCPLineEnding &ending)
 {
   mAxisPainter->lowerEnding = ending;
+  markDirty();
 }
 
 /*!
@@ -8403,6 +9023,7 @@ void QCPAxis::setLowerEnding(const QCPLineEnding &ending)
 void QCPAxis::setUpperEnding(const QCPLineEnding &ending)
 {
   mAxisPainter->upperEnding = ending;
+  markDirty();
 }
 
 /*!
@@ -10303,210 +10924,925 @@ void QCPScatterStyle::drawShape(QCPPainter *painter, double x, double y) const
 
 //amalgamation: add datacontainer.cpp
 
-/* including file 'src/plottable.cpp', size 38845                            */
-/* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
-
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////// QCPSelectionDecorator
+//////////////////// QCPDataColumn
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/*! \class QCPSelectionDecorator
-  \brief Controls how a plottable's data selection is drawn
+/*! \class QCPDataColumn
+  \brief The abstract base class for a single column of floating point samples
   
-  Each \ref QCPAbstractPlottable instance has one \ref QCPSelectionDecorator (accessible via \ref
-  QCPAbstractPlottable::selectionDecorator) and uses it when drawing selected segments of its data.
+  A data column holds one coordinate (e.g. only the keys or only the values) of a data set. Two
+  columns together form a structure-of-arrays data set such as \ref QCPGraphColumnData, which
+  QCPGraph can display instead of its regular \ref QCPGraphDataContainer (see \ref
+  QCPGraph::setData(QSharedPointer<QCPDataColumn>, QSharedPointer<QCPDataColumn>)).
   
-  The selection decorator controls both pen (\ref setPen) and brush (\ref setBrush), as well as the
-  scatter style (\ref setScatterStyle) if the plottable draws scatters. Since a \ref
-  QCPScatterStyle is itself composed of different properties such as color shape and size, the
-  decorator allows specifying exactly which of those properties shall be used for the selected data
-  point, via \ref setUsedScatterProperties.
+  Compared to the interleaved storage of a \ref QCPDataContainer, keeping every coordinate in its
+  own contiguous array halves the memory traffic of operations that only need one of the
+  coordinates, such as finding the visible key range or determining the value extremes of a pixel
+  interval. The scans in \ref range are tight loops over contiguous memory that the compiler can
+  vectorize.
   
-  A \ref QCPSelectionDecorator subclass instance can be passed to a plottable via \ref
-  QCPAbstractPlottable::setSelectionDecorator, allowing greater customizability of the appearance
-  of selected segments.
+  \section qcpdatacolumn-subclassing Creating own data columns
   
-  Use \ref copyFrom to easily transfer the settings of one decorator to another one. This is
-  especially useful since plottables take ownership of the passed selection decorator, and thus the
-  same decorator instance can not be passed to multiple plottables.
+  Subclasses keep \a mSize up to date with the number of samples. If the samples are available as a
+  contiguous array of doubles, subclasses additionally set \a mConstData to point to it, which
+  allows the fast inline access path of \ref at and the default implementations of \ref
+  lowerBound, \ref upperBound and \ref range to work directly on that memory. Otherwise \a
+  mConstData must be zero and the subclass returns the individual samples via \ref valueAt. When
+  the samples are replaced, subclasses call \ref clearSearchCache.
   
-  Selection decorators can also themselves perform drawing operations by reimplementing \ref
-  drawDecoration, which is called by the plottable's draw method. The base class \ref
-  QCPSelectionDecorator does not make use of this however. For example, \ref
-  QCPSelectionDecoratorBracket draws brackets around selected data segments.
+  Subclasses that can locate keys or determine ranges faster than by binary search and linear
+  scans (e.g. because the samples follow a known rule) may reimplement \ref lowerBound, \ref
+  upperBound and \ref range.
+  
+  \section qcpdatacolumn-sharing Sharing columns
+  
+  A key column may be shared by several graphs whose values were sampled at the same keys. Such
+  graphs typically search the same visible key range in the same column during a replot. The
+  searches over the whole column are therefore memoized by \ref cachedLowerBound and \ref
+  cachedUpperBound for the duration of one replot, so only the first graph pays for them.
+  
+  \see QCPDoubleColumn, QCPBufferColumn, QCPScaledColumn, QCPUniformColumn
+  
+  Data columns are shared via QSharedPointer and can't be copied.
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn int QCPDataColumn::size() const
+  
+  Returns the number of samples in this column.
+*/
+
+/*! \fn bool QCPDataColumn::isEmpty() const
+  
+  Returns whether this column contains no samples.
+*/
+
+/*! \fn const double *QCPDataColumn::constData() const
+  
+  Returns a pointer to the contiguous array of \ref size doubles holding the samples of this
+  column, or 0 if the column doesn't store its samples as a plain double array.
+*/
+
+/*! \fn double QCPDataColumn::at(int index) const
+  
+  Returns the sample at \a index. The index must be valid, i.e. in the range 0 to \ref size - 1.
+*/
+
+/*! \fn uint QCPDataColumn::revision() const
+  
+  Returns a number that identifies the current samples of this column. It changes whenever the
+  samples are replaced (see \ref clearSearchCache) or \ref markChanged is called, and is unique
+  among all columns, so QCPGraph can tell whether a line it sampled from this column is still up
+  to date, even if the column was exchanged for a different one.
+*/
+
+/*! \fn virtual bool QCPDataColumn::hasConstantTimeSearch() const
+  
+  Returns whether \ref lowerBound and \ref upperBound find their result in constant time instead
+  of performing a binary search. The default implementation returns false.
+  
+  The adaptive sampling of QCPGraph uses this to decide whether to look for the end of a pixel
+  interval by probing the following samples individually first, which only pays off if a search is
+  expensive compared to reading a few samples.
+*/
+
+/* end documentation of inline functions */
+
+/* start documentation of pure virtual functions */
+
+/*! \fn virtual double QCPDataColumn::valueAt(int index) const = 0
+  \internal
+  
+  Returns the sample at \a index. This is called by \ref at if the column doesn't provide its
+  samples as a contiguous double array via \a mConstData.
+  
+  If the plotting hint \ref QCP::phParallelSampling is set, this method may be called concurrently
+  from multiple threads while a graph samples the column, so it must not modify shared state
+  without synchronization.
 */
 
+/* end documentation of pure virtual functions */
+
 /*!
-  Creates a new QCPSelectionDecorator instance with default values
+  Constructs an empty data column.
 */
-QCPSelectionDecorator::QCPSelectionDecorator() :
-  mPen(QColor(80, 80, 255), 2.5),
-  mBrush(Qt::NoBrush),
-  mScatterStyle(),
-  mUsedScatterProperties(QCPScatterStyle::spNone),
-  mPlottable(0)
+QCPDataColumn::QCPDataColumn() :
+  mSize(0),
+  mConstData(0),
+  mSearchCacheNext(0),
+  mRevision(0)
 {
+  clearSearchCache();
 }
 
-QCPSelectionDecorator::~QCPSelectionDecorator()
+QCPDataColumn::~QCPDataColumn()
 {
 }
 
 /*!
-  Sets the pen that will be used by the parent plottable to draw selected data segments.
+  Returns the index of the first sample in the index range \a begin to \a end (exclusive) which is
+  not smaller than \a value, or \a end if there is no such sample.
+  
+  The samples in the searched index range must be sorted in ascending order, as is the case for
+  the key column of a \ref QCPGraphColumnData.
+  
+  \see upperBound
 */
-void QCPSelectionDecorator::setPen(const QPen &pen)
+int QCPDataColumn::lowerBound(double value, int begin, int end) const
 {
-  mPen = pen;
+  if (mConstData)
+    return std::lower_bound(mConstData+begin, mConstData+end, value)-mConstData;
+  
+  int count = end-begin;
+  while (count > 0)
+  {
+    const int step = count/2;
+    if (valueAt(begin+step) < value)
+    {
+      begin += step+1;
+      count -= step+1;
+    } else
+      count = step;
+  }
+  return begin;
 }
 
 /*!
-  Sets the brush that will be used by the parent plottable to draw selected data segments.
+  Returns the index of the first sample in the index range \a begin to \a end (exclusive) which is
+  greater than \a value, or \a end if there is no such sample.
+  
+  The samples in the searched index range must be sorted in ascending order, as is the case for
+  the key column of a \ref QCPGraphColumnData.
+  
+  \see lowerBound
 */
-void QCPSelectionDecorator::setBrush(const QBrush &brush)
+int QCPDataColumn::upperBound(double value, int begin, int end) const
 {
-  mBrush = brush;
+  if (mConstData)
+    return std::upper_bound(mConstData+begin, mConstData+end, value)-mConstData;
+  
+  int count = end-begin;
+  while (count > 0)
+  {
+    const int step = count/2;
+    if (!(value < valueAt(begin+step)))
+    {
+      begin += step+1;
+      count -= step+1;
+    } else
+      count = step;
+  }
+  return begin;
 }
 
 /*!
-  Sets the scatter style that will be used by the parent plottable to draw scatters in selected
-  data segments.
+  Returns the range spanned by the samples in the index range \a begin to \a end (exclusive). NaN
+  samples are ignored. If \a signDomain is \ref QCP::sdPositive or \ref QCP::sdNegative, only
+  samples in the respective sign domain are taken into account.
   
-  \a usedProperties specifies which parts of the passed \a scatterStyle will be used by the
-  plottable. The used properties can also be changed via \ref setUsedScatterProperties.
+  \a foundRange indicates whether a range could be found, i.e. whether there was at least one
+  sample in the index range that wasn't NaN and fell into \a signDomain.
 */
-void QCPSelectionDecorator::setScatterStyle(const QCPScatterStyle &scatterStyle, QCPScatterStyle::ScatterProperties usedProperties)
+QCPRange QCPDataColumn::range(bool &foundRange, int begin, int end, QCP::SignDomain signDomain) const
 {
-  mScatterStyle = scatterStyle;
-  setUsedScatterProperties(usedProperties);
+  begin = qMax(begin, 0);
+  end = qMin(end, mSize);
+  double lower = std::numeric_limits<double>::infinity();
+  double upper = -std::numeric_limits<double>::infinity();
+  // comparisons with NaN are always false, so NaN samples are skipped without extra branches:
+  if (signDomain == QCP::sdBoth)
+  {
+    for (int i=begin; i<end; ++i)
+    {
+      const double current = at(i);
+      if (current < lower)
+        lower = current;
+      if (current > upper)
+        upper = current;
+    }
+  } else if (signDomain == QCP::sdNegative)
+  {
+    for (int i=begin; i<end; ++i)
+    {
+      const double current = at(i);
+      if (current < lower && current < 0)
+        lower = current;
+      if (current > upper && current < 0)
+        upper = current;
+    }
+  } else if (signDomain == QCP::sdPositive)
+  {
+    for (int i=begin; i<end; ++i)
+    {
+      const double current = at(i);
+      if (current < lower && current > 0)
+        lower = current;
+      if (current > upper && current > 0)
+        upper = current;
+    }
+  }
+  
+  foundRange = lower <= upper;
+  if (!foundRange)
+    return QCPRange();
+  return QCPRange(lower, upper);
 }
 
 /*!
-  Use this method to define which properties of the scatter style (set via \ref setScatterStyle)
-  will be used for selected data segments. All properties of the scatter style that are not
-  specified in \a properties will remain as specified in the plottable's original scatter style.
+  Returns the same as \ref lowerBound over the entire column, i.e. the index of the first sample
+  not smaller than \a value.
   
-  \see QCPScatterStyle::ScatterProperty
+  If \a cacheSerial is not zero, the result is memoized together with \a cacheSerial, and repeated
+  calls with the same \a value and \a cacheSerial return the memoized result without searching
+  again. The serial identifies a period during which the samples don't change. QCPGraph passes the
+  serial of the current replot, so graphs sharing this column as key column only search the
+  visible key range once per replot. Outside of a replot, \a cacheSerial is zero and the column is
+  searched every time.
+  
+  \see cachedUpperBound
 */
-void QCPSelectionDecorator::setUsedScatterProperties(const QCPScatterStyle::ScatterProperties &properties)
+int QCPDataColumn::cachedLowerBound(double value, uint cacheSerial) const
 {
-  mUsedScatterProperties = properties;
+  return cachedSearch(value, false, cacheSerial);
 }
 
 /*!
-  Sets the pen of \a painter to the pen of this selection decorator.
+  Returns the same as \ref upperBound over the entire column, i.e. the index of the first sample
+  greater than \a value. The result is memoized per \a cacheSerial, see \ref cachedLowerBound.
   
-  \see applyBrush, getFinalScatterStyle
+  \see cachedLowerBound
 */
-void QCPSelectionDecorator::applyPen(QCPPainter *painter) const
+int QCPDataColumn::cachedUpperBound(double value, uint cacheSerial) const
 {
-  painter->setPen(mPen);
+  return cachedSearch(value, true, cacheSerial);
 }
 
-/*!
-  Sets the brush of \a painter to the brush of this selection decorator.
+/*! \internal
   
-  \see applyPen, getFinalScatterStyle
+  Implements \ref cachedLowerBound and \ref cachedUpperBound. The cache holds the most recent few
+  searches, so graphs on axes with different visible ranges don't evict each other's results.
+  Entries of an older serial or a different column size never match.
 */
-void QCPSelectionDecorator::applyBrush(QCPPainter *painter) const
+int QCPDataColumn::cachedSearch(double value, bool upper, uint cacheSerial) const
 {
-  painter->setBrush(mBrush);
+  if (cacheSerial == 0)
+    return upper ? upperBound(value, 0, mSize) : lowerBound(value, 0, mSize);
+  
+  for (int i=0; i<searchCacheSize; ++i)
+  {
+    const SearchCacheEntry &entry = mSearchCache[i];
+    if (entry.serial == cacheSerial && entry.upper == upper && entry.value == value && entry.size == mSize)
+      return entry.result;
+  }
+  
+  SearchCacheEntry &entry = mSearchCache[mSearchCacheNext];
+  mSearchCacheNext = (mSearchCacheNext+1) % searchCacheSize;
+  entry.serial = cacheSerial;
+  entry.upper = upper;
+  entry.value = value;
+  entry.size = mSize;
+  entry.result = upper ? upperBound(value, 0, mSize) : lowerBound(value, 0, mSize);
+  return entry.result;
 }
 
 /*!
-  Returns the scatter style that the parent plottable shall use for selected scatter points. The
-  plottable's original (unselected) scatter style must be passed as \a unselectedStyle. Depending
-  on the setting of \ref setUsedScatterProperties, the returned scatter style is a mixture of this
-  selecion decorator's scatter style (\ref setScatterStyle), and \a unselectedStyle.
+  Notifies the column that its samples were modified in place, i.e. without replacing them through
+  the column's own methods. This is necessary for columns that refer to external memory, such as a
+  \ref QCPBufferColumn whose buffer is rewritten by a live acquisition. The column then discards
+  its memoized search results and increases its \ref revision, so graphs don't reuse lines they
+  sampled from the previous samples.
   
-  \see applyPen, applyBrush, setScatterStyle
+  Call this before the next replot after each in-place modification.
 */
-QCPScatterStyle QCPSelectionDecorator::getFinalScatterStyle(const QCPScatterStyle &unselectedStyle) const
+void QCPDataColumn::markChanged()
 {
-  QCPScatterStyle result(unselectedStyle);
-  result.setFromOther(mScatterStyle, mUsedScatterProperties);
+  clearSearchCache();
+}
+
+/*! \internal
   
-  // if style shall inherit pen from plottable (has no own pen defined), give it the selected
-  // plottable pen explicitly, so it doesn't use the unselected plottable pen when used in the
-  // plottable:
-  if (!result.isPenDefined())
-    result.setPen(mPen);
+  Discards all memoized search results and assigns a new \ref revision to the column. Subclasses
+  call this when the samples of the column are replaced, so results of the current replot aren't
+  reused for different samples.
+*/
+void QCPDataColumn::clearSearchCache()
+{
+  static QBasicAtomicInt revisionCounter = Q_BASIC_ATOMIC_INITIALIZER(0);
+  for (int i=0; i<searchCacheSize; ++i)
+    mSearchCache[i].serial = 0;
+  mRevision = uint(revisionCounter.fetchAndAddRelaxed(1))+1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPDoubleColumn
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPDoubleColumn
+  \brief A data column that stores its samples in an owned QVector<double>
   
-  return result;
+  This is the basic \ref QCPDataColumn implementation. The samples are held in a QVector<double>,
+  which is implicitly shared: Passing an existing vector to the constructor or to \ref setData
+  doesn't copy the samples until either side modifies them.
+  
+  When this column is used as key column of a \ref QCPGraphColumnData, the samples must be sorted
+  in ascending order.
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn QVector<double> QCPDoubleColumn::data() const
+  
+  Returns the samples of this column. Since QVector is implicitly shared, this doesn't copy the
+  samples.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs an empty data column.
+*/
+QCPDoubleColumn::QCPDoubleColumn()
+{
 }
 
 /*!
-  Copies all properties (e.g. color, fill, scatter style) of the \a other selection decorator to
-  this selection decorator.
+  Constructs a data column holding the samples in \a data.
 */
-void QCPSelectionDecorator::copyFrom(const QCPSelectionDecorator *other)
+QCPDoubleColumn::QCPDoubleColumn(const QVector<double> &data) :
+  mData(data)
+{
+  updateDataView();
+}
+
+QCPDoubleColumn::~QCPDoubleColumn()
 {
-  setPen(other->pen());
-  setBrush(other->brush());
-  setScatterStyle(other->scatterStyle(), other->usedScatterProperties());
 }
 
 /*!
-  This method is called by all plottables' draw methods to allow custom selection decorations to be
-  drawn. Use the passed \a painter to perform the drawing operations. \a selection carries the data
-  selection for which the decoration shall be drawn.
+  Replaces the samples of this column with \a data.
   
-  The default base class implementation of \ref QCPSelectionDecorator has no special decoration, so
-  this method does nothing.
+  \see add, clear
 */
-void QCPSelectionDecorator::drawDecoration(QCPPainter *painter, QCPDataSelection selection)
+void QCPDoubleColumn::setData(const QVector<double> &data)
 {
-  Q_UNUSED(painter)
-  Q_UNUSED(selection)
+  mData = data;
+  updateDataView();
 }
 
-/*! \internal
+/*! \overload
   
-  This method is called as soon as a selection decorator is associated with a plottable, by a call
-  to \ref QCPAbstractPlottable::setSelectionDecorator. This way the selection decorator can obtain a pointer to the plottable that uses it (e.g. to access
-  data points via the \ref QCPAbstractPlottable::interface1D interface).
+  Appends the samples in \a data to the end of this column.
   
-  If the selection decorator was already added to a different plottable before, this method aborts
-  the registration and returns false.
+  \see setData
 */
-bool QCPSelectionDecorator::registerWithPlottable(QCPAbstractPlottable *plottable)
+void QCPDoubleColumn::add(const QVector<double> &data)
 {
-  if (!mPlottable)
-  {
-    mPlottable = plottable;
-    return true;
-  } else
-  {
-    qDebug() << Q_FUNC_INFO << "This selection decorator is already registered with plottable:" << reinterpret_cast<quintptr>(mPlottable);
-    return false;
-  }
+  mData << data;
+  updateDataView();
 }
 
+/*! \overload
+  
+  Appends the sample \a value to the end of this column.
+  
+  \see setData
+*/
+void QCPDoubleColumn::add(double value)
+{
+  mData.append(value);
+  updateDataView();
+}
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////// QCPAbstractPlottable
-////////////////////////////////////////////////////////////////////////////////////////////////////
+/*!
+  Removes all samples from this column.
+  
+  \see setData
+*/
+void QCPDoubleColumn::clear()
+{
+  mData.clear();
+  updateDataView();
+}
 
-/*! \class QCPAbstractPlottable
-  \brief The abstract base class for all data representing objects in a plot.
+/* inherits documentation from base class */
+double QCPDoubleColumn::valueAt(int index) const
+{
+  return mData.at(index);
+}
 
-  It defines a very basic interface like name, pen, brush, visibility etc. Since this class is
-  abstract, it can't be instantiated. Use one of the subclasses or create a subclass yourself to
-  create new ways of displaying data (see "Creating own plottables" below). Plottables that display
-  one-dimensional data (i.e. data points have a single key dimension and one or multiple values at
-  each key) are based off of the template subclass \ref QCPAbstractPlottable1D, see details
-  there.
+/*! \internal
   
-  All further specifics are in the subclasses, for example:
-  \li A normal graph with possibly a line and/or scatter points \ref QCPGraph
-  (typically created with \ref QCustomPlot::addGraph)
-  \li A parametric curve: \ref QCPCurve
-  \li A bar chart: \ref QCPBars
-  \li A statistical box plot: \ref QCPStatisticalBox
-  \li A color encoded two-dimensional map: \ref QCPColorMap
-  \li An OHLC/Candlestick chart: \ref QCPFinancial
+  Updates the size and data pointer of the base class after \a mData was modified.
+*/
+void QCPDoubleColumn::updateDataView()
+{
+  mSize = mData.size();
+  mConstData = mData.constData();
+  clearSearchCache();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPBufferColumn
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPBufferColumn
+  \brief A data column that adopts an external buffer of doubles without copying it
   
-  \section plottables-subclassing Creating own plottables
+  This column doesn't own its samples. It refers to a contiguous array of doubles that is provided
+  by the caller, for example a large acquisition buffer. The samples are neither copied nor
+  converted, the draw path of QCPGraph reads them directly from the buffer.
+  
+  The buffer must stay valid and unmodified in size as long as the column refers to it. To tie the
+  lifetime of the buffer to the column, pass a lifetime handle as \a owner to the constructor or to
+  \ref setBuffer. The handle can be any copyable object that keeps the buffer alive, such as a
+  QSharedPointer to the object that holds the buffer, or the implicitly shared QVector<double>
+  itself. The column keeps a copy of the handle until it is destroyed or a different buffer is
+  set:
+  \code
+  QVector<double> keys = acquireKeys(); // already sorted
+  QSharedPointer<QCPDataColumn> keyColumn(new QCPBufferColumn(keys.constData(), keys.size(), keys));
+  \endcode
+  
+  If no lifetime handle is passed, the caller is responsible for keeping the buffer alive.
+  
+  The samples in the buffer may be rewritten in place, e.g. by a live acquisition. The column
+  can't detect this, so \ref markChanged must be called after each such modification. Otherwise,
+  graphs may keep showing lines they sampled from the previous samples. If the plotting hint \ref
+  QCP::phSkipCleanLayers is set, the graphs displaying the column must also be marked dirty (see
+  \ref QCPLayerable::markDirty).
+  
+  When this column is used as key column of a \ref QCPGraphColumnData, the samples must be sorted
+  in ascending order.
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn QCPBufferColumn::QCPBufferColumn(const double *data, int size, const Owner &owner)
+  
+  Constructs a column that refers to the \a size doubles at \a data. A copy of \a owner is kept
+  as lifetime handle of the buffer until the column is destroyed or \ref setBuffer is called.
+*/
+
+/*! \fn void QCPBufferColumn::setBuffer(const double *data, int size, const Owner &owner)
+  
+  Makes the column refer to the \a size doubles at \a data. A copy of \a owner is kept as lifetime
+  handle of the buffer until the column is destroyed or \ref setBuffer is called again. The
+  lifetime handle of the previous buffer is released.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs an empty column that doesn't refer to any buffer.
+*/
+QCPBufferColumn::QCPBufferColumn() :
+  mOwner(0)
+{
+}
+
+/*!
+  Constructs a column that refers to the \a size doubles at \a data. The caller must keep the
+  buffer alive as long as the column refers to it.
+*/
+QCPBufferColumn::QCPBufferColumn(const double *data, int size) :
+  mOwner(0)
+{
+  adoptBuffer(data, size, 0);
+}
+
+QCPBufferColumn::~QCPBufferColumn()
+{
+  delete mOwner;
+}
+
+/*! \overload
+  
+  Makes the column refer to the \a size doubles at \a data. The caller must keep the buffer alive
+  as long as the column refers to it. The lifetime handle of the previous buffer, if any, is
+  released.
+*/
+void QCPBufferColumn::setBuffer(const double *data, int size)
+{
+  adoptBuffer(data, size, 0);
+}
+
+/* inherits documentation from base class */
+double QCPBufferColumn::valueAt(int index) const
+{
+  return mConstData[index];
+}
+
+/*! \internal
+  
+  Makes the column refer to \a size doubles at \a data and takes ownership of the lifetime handle
+  \a owner, which may be 0. The previous lifetime handle is released after the new one was set, so
+  re-adopting a buffer that is only kept alive by the current handle is safe.
+*/
+void QCPBufferColumn::adoptBuffer(const double *data, int size, AbstractOwner *owner)
+{
+  AbstractOwner *previousOwner = mOwner;
+  mOwner = owner;
+  mConstData = data;
+  mSize = data ? qMax(0, size) : 0;
+  clearSearchCache();
+  delete previousOwner;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPUniformColumn
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPUniformColumn
+  \brief A data column of evenly spaced samples that are calculated instead of stored
+  
+  The sample at index \a i of this column is <tt>start + i*step</tt>, see \ref setStart, \ref
+  setStep and \ref setSize. No samples are stored, so the column uses constant memory regardless
+  of its size. This is the natural key column for data that was acquired at a fixed sample rate,
+  where storing a timestamp for every sample would double the memory footprint of the data set:
+  \code
+  QSharedPointer<QCPDataColumn> keys(new QCPUniformColumn(t0, 1.0/sampleRate, values->size()));
+  graph->setData(keys, values);
+  \endcode
+  
+  With a positive step, \ref lowerBound and \ref upperBound compute the searched index directly
+  instead of performing a binary search, and \ref range only evaluates the first and last sample of
+  the index range. Finding the visible data range of a graph (\ref QCPGraph::findBegin, \ref
+  QCPGraph::findEnd) therefore takes constant time, and the adaptive sampling of QCPGraph
+  determines the data points of each pixel interval directly from their indices (see \ref
+  hasConstantTimeSearch).
+  
+  When this column is used as key column of a \ref QCPGraphColumnData, the step must not be
+  negative. Since the column doesn't follow the size of the value column automatically, call \ref
+  setSize when samples are appended to the value column.
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn double QCPUniformColumn::start() const
+  
+  Returns the value of the first sample. See \ref setStart.
+*/
+
+/*! \fn double QCPUniformColumn::step() const
+  
+  Returns the difference between consecutive samples. See \ref setStep.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs an empty column with a start of 0 and a step of 1.
+*/
+QCPUniformColumn::QCPUniformColumn() :
+  mStart(0),
+  mStep(1)
+{
+}
+
+/*!
+  Constructs a column of \a size samples, the first of which is \a start, with a difference of \a
+  step between consecutive samples.
+*/
+QCPUniformColumn::QCPUniformColumn(double start, double step, int size) :
+  mStart(start),
+  mStep(step)
+{
+  mSize = qMax(0, size);
+}
+
+QCPUniformColumn::~QCPUniformColumn()
+{
+}
+
+/*!
+  Sets the value of the first sample.
+  
+  \see setStep
+*/
+void QCPUniformColumn::setStart(double start)
+{
+  mStart = start;
+  clearSearchCache();
+}
+
+/*!
+  Sets the difference between consecutive samples. For key columns, \a step must not be negative.
+  
+  \see setStart
+*/
+void QCPUniformColumn::setStep(double step)
+{
+  mStep = step;
+  clearSearchCache();
+}
+
+/*!
+  Sets the number of samples of this column.
+*/
+void QCPUniformColumn::setSize(int size)
+{
+  mSize = qMax(0, size);
+  clearSearchCache();
+}
+
+/*!
+  Returns the index of the first sample in the index range \a begin to \a end (exclusive) which is
+  not smaller than \a value, or \a end if there is no such sample.
+  
+  With a positive step, the index is calculated in constant time. The result is identical to a
+  binary search over the samples as returned by \ref at, including the rounding of the samples.
+*/
+int QCPUniformColumn::lowerBound(double value, int begin, int end) const
+{
+  if (!(mStep > 0))
+    return QCPDataColumn::lowerBound(value, begin, end);
+  
+  int index = estimateIndex(value, begin, end);
+  // the estimate may be off by one due to floating point rounding, so correct it against the samples:
+  while (index > begin && !(valueAt(index-1) < value))
+    --index;
+  while (index < end && valueAt(index) < value)
+    ++index;
+  return index;
+}
+
+/*!
+  Returns the index of the first sample in the index range \a begin to \a end (exclusive) which is
+  greater than \a value, or \a end if there is no such sample.
+  
+  With a positive step, the index is calculated in constant time. The result is identical to a
+  binary search over the samples as returned by \ref at, including the rounding of the samples.
+*/
+int QCPUniformColumn::upperBound(double value, int begin, int end) const
+{
+  if (!(mStep > 0))
+    return QCPDataColumn::upperBound(value, begin, end);
+  if (qIsNaN(value)) // comparisons with NaN are false, so no sample is greater
+    return qMax(begin, end);
+  
+  int index = estimateIndex(value, begin, end);
+  // the estimate may be off by one due to floating point rounding, so correct it against the samples:
+  while (index > begin && value < valueAt(index-1))
+    --index;
+  while (index < end && !(value < valueAt(index)))
+    ++index;
+  return index;
+}
+
+/*!
+  Returns the range spanned by the samples in the index range \a begin to \a end (exclusive). If \a
+  signDomain is \ref QCP::sdPositive or \ref QCP::sdNegative, only samples in the respective sign
+  domain are taken into account.
+  
+  Since the samples are sorted for a step that isn't negative, only the boundary samples of the
+  index range are evaluated. Columns with negative or non-finite steps are scanned like in the
+  base class implementation.
+*/
+QCPRange QCPUniformColumn::range(bool &foundRange, int begin, int end, QCP::SignDomain signDomain) const
+{
+  if (!(mStep >= 0) || qIsNaN(mStart) || qIsInf(mStart) || qIsInf(mStep))
+    return QCPDataColumn::range(foundRange, begin, end, signDomain);
+  
+  begin = qMax(begin, 0);
+  end = qMin(end, mSize);
+  if (signDomain == QCP::sdPositive)
+    begin = upperBound(0, begin, end);
+  else if (signDomain == QCP::sdNegative)
+    end = lowerBound(0, begin, end);
+  
+  foundRange = begin < end;
+  if (!foundRange)
+    return QCPRange();
+  return QCPRange(valueAt(begin), valueAt(end-1));
+}
+
+/*! \internal
+  
+  Returns the index of the first sample not smaller than \a value, as calculated from the start
+  and step of the column, clamped to the index range \a begin to \a end. Due to floating point
+  rounding, the result may deviate by one index from the exact search result. This method may only
+  be called if the step is positive.
+*/
+int QCPUniformColumn::estimateIndex(double value, int begin, int end) const
+{
+  if (begin >= end)
+    return begin;
+  const double index = (value-mStart)/mStep;
+  if (!(index > begin)) // also catches NaN
+    return begin;
+  if (!(index < end))
+    return end;
+  return int(ceil(index));
+}
+
+
+/* including file 'src/plottable.cpp', size 38845                            */
+/* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPSelectionDecorator
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPSelectionDecorator
+  \brief Controls how a plottable's data selection is drawn
+  
+  Each \ref QCPAbstractPlottable instance has one \ref QCPSelectionDecorator (accessible via \ref
+  QCPAbstractPlottable::selectionDecorator) and uses it when drawing selected segments of its data.
+  
+  The selection decorator controls both pen (\ref setPen) and brush (\ref setBrush), as well as the
+  scatter style (\ref setScatterStyle) if the plottable draws scatters. Since a \ref
+  QCPScatterStyle is itself composed of different properties such as color shape and size, the
+  decorator allows specifying exactly which of those properties shall be used for the selected data
+  point, via \ref setUsedScatterProperties.
+  
+  A \ref QCPSelectionDecorator subclass instance can be passed to a plottable via \ref
+  QCPAbstractPlottable::setSelectionDecorator, allowing greater customizability of the appearance
+  of selected segments.
+  
+  Use \ref copyFrom to easily transfer the settings of one decorator to another one. This is
+  especially useful since plottables take ownership of the passed selection decorator, and thus the
+  same decorator instance can not be passed to multiple plottables.
+  
+  Selection decorators can also themselves perform drawing operations by reimplementing \ref
+  drawDecoration, which is called by the plottable's draw method. The base class \ref
+  QCPSelectionDecorator does not make use of this however. For example, \ref
+  QCPSelectionDecoratorBracket draws brackets around selected data segments.
+*/
+
+/*!
+  Creates a new QCPSelectionDecorator instance with default values
+*/
+QCPSelectionDecorator::QCPSelectionDecorator() :
+  mPen(QColor(80, 80, 255), 2.5),
+  mBrush(Qt::NoBrush),
+  mScatterStyle(),
+  mUsedScatterProperties(QCPScatterStyle::spNone),
+  mPlottable(0)
+{
+}
+
+QCPSelectionDecorator::~QCPSelectionDecorator()
+{
+}
+
+/*!
+  Sets the pen that will be used by the parent plottable to draw selected data segments.
+*/
+void QCPSelectionDecorator::setPen(const QPen &pen)
+{
+  mPen = pen;
+}
+
+/*!
+  Sets the brush that will be used by the parent plottable to draw selected data segments.
+*/
+void QCPSelectionDecorator::setBrush(const QBrush &brush)
+{
+  mBrush = brush;
+}
+
+/*!
+  Sets the scatter style that will be used by the parent plottable to draw scatters in selected
+  data segments.
+  
+  \a usedProperties specifies which parts of the passed \a scatterStyle will be used by the
+  plottable. The used properties can also be changed via \ref setUsedScatterProperties.
+*/
+void QCPSelectionDecorator::setScatterStyle(const QCPScatterStyle &scatterStyle, QCPScatterStyle::ScatterProperties usedProperties)
+{
+  mScatterStyle = scatterStyle;
+  setUsedScatterProperties(usedProperties);
+}
+
+/*!
+  Use this method to define which properties of the scatter style (set via \ref setScatterStyle)
+  will be used for selected data segments. All properties of the scatter style that are not
+  specified in \a properties will remain as specified in the plottable's original scatter style.
+  
+  \see QCPScatterStyle::ScatterProperty
+*/
+void QCPSelectionDecorator::setUsedScatterProperties(const QCPScatterStyle::ScatterProperties &properties)
+{
+  mUsedScatterProperties = properties;
+}
+
+/*!
+  Sets the pen of \a painter to the pen of this selection decorator.
+  
+  \see applyBrush, getFinalScatterStyle
+*/
+void QCPSelectionDecorator::applyPen(QCPPainter *painter) const
+{
+  painter->setPen(mPen);
+}
+
+/*!
+  Sets the brush of \a painter to the brush of this selection decorator.
+  
+  \see applyPen, getFinalScatterStyle
+*/
+void QCPSelectionDecorator::applyBrush(QCPPainter *painter) const
+{
+  painter->setBrush(mBrush);
+}
+
+/*!
+  Returns the scatter style that the parent plottable shall use for selected scatter points. The
+  plottable's original (unselected) scatter style must be passed as \a unselectedStyle. Depending
+  on the setting of \ref setUsedScatterProperties, the returned scatter style is a mixture of this
+  selecion decorator's scatter style (\ref setScatterStyle), and \a unselectedStyle.
+  
+  \see applyPen, applyBrush, setScatterStyle
+*/
+QCPScatterStyle QCPSelectionDecorator::getFinalScatterStyle(const QCPScatterStyle &unselectedStyle) const
+{
+  QCPScatterStyle result(unselectedStyle);
+  result.setFromOther(mScatterStyle, mUsedScatterProperties);
+  
+  // if style shall inherit pen from plottable (has no own pen defined), give it the selected
+  // plottable pen explicitly, so it doesn't use the unselected plottable pen when used in the
+  // plottable:
+  if (!result.isPenDefined())
+    result.setPen(mPen);
+  
+  return result;
+}
+
+/*!
+  Copies all properties (e.g. color, fill, scatter style) of the \a other selection decorator to
+  this selection decorator.
+*/
+void QCPSelectionDecorator::copyFrom(const QCPSelectionDecorator *other)
+{
+  setPen(other->pen());
+  setBrush(other->brush());
+  setScatterStyle(other->scatterStyle(), other->usedScatterProperties());
+}
+
+/*!
+  This method is called by all plottables' draw methods to allow custom selection decorations to be
+  drawn. Use the passed \a painter to perform the drawing operations. \a selection carries the data
+  selection for which the decoration shall be drawn.
+  
+  The default base class implementation of \ref QCPSelectionDecorator has no special decoration, so
+  this method does nothing.
+*/
+void QCPSelectionDecorator::drawDecoration(QCPPainter *painter, QCPDataSelection selection)
+{
+  Q_UNUSED(painter)
+  Q_UNUSED(selection)
+}
+
+/*! \internal
+  
+  This method is called as soon as a selection decorator is associated with a plottable, by a call
+  to \ref QCPAbstractPlottable::setSelectionDecorator. This way the selection decorator can obtain a pointer to the plottable that uses it (e.g. to access
+  data points via the \ref QCPAbstractPlottable::interface1D interface).
+  
+  If the selection decorator was already added to a different plottable before, this method aborts
+  the registration and returns false.
+*/
+bool QCPSelectionDecorator::registerWithPlottable(QCPAbstractPlottable *plottable)
+{
+  if (!mPlottable)
+  {
+    mPlottable = plottable;
+    return true;
+  } else
+  {
+    qDebug() << Q_FUNC_INFO << "This selection decorator is already registered with plottable:" << reinterpret_cast<quintptr>(mPlottable);
+    return false;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPAbstractPlottable
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPAbstractPlottable
+  \brief The abstract base class for all data representing objects in a plot.
+
+  It defines a very basic interface like name, pen, brush, visibility etc. Since this class is
+  abstract, it can't be instantiated. Use one of the subclasses or create a subclass yourself to
+  create new ways of displaying data (see "Creating own plottables" below). Plottables that display
+  one-dimensional data (i.e. data points have a single key dimension and one or multiple values at
+  each key) are based off of the template subclass \ref QCPAbstractPlottable1D, see details
+  there.
+  
+  All further specifics are in the subclasses, for example:
+  \li A normal graph with possibly a line and/or scatter points \ref QCPGraph
+  (typically created with \ref QCustomPlot::addGraph)
+  \li A parametric curve: \ref QCPCurve
+  \li A bar chart: \ref QCPBars
+  \li A statistical box plot: \ref QCPStatisticalBox
+  \li A color encoded two-dimensional map: \ref QCPColorMap
+  \li An OHLC/Candlestick chart: \ref QCPFinancial
+  
+  \section plottables-subclassing Creating own plottables
   
   Subclassing directly from QCPAbstractPlottable is only recommended if you wish to display
   two-dimensional data like \ref QCPColorMap, i.e. two logical key dimensions and one (or more)
@@ -10604,6 +11940,15 @@ bool QCPSelectionDecorator::registerWithPlottable(QCPAbstractPlottable *plottabl
   abstract base class only.
 */
 
+/*! \fn virtual void QCPAbstractPlottable::takeQueuedData()
+  \internal
+  
+  Called by \ref QCustomPlot::replot at the beginning of each replot, before the \ref
+  QCustomPlot::beforeReplot signal is emitted. Plottables that accept data from other threads
+  (see \ref QCPAbstractPlottable1D::setDataQueue) add the pending data to their data container
+  here. The default implementation does nothing.
+*/
+
 /* end of documentation of inline functions */
 /* start of documentation of pure virtual functions */
 
@@ -10735,6 +12080,7 @@ QCPAbstractPlottable::~QCPAbstractPlottable()
 void QCPAbstractPlottable::setName(const QString &name)
 {
   mName = name;
+  markDirty();
 }
 
 /*!
@@ -10746,6 +12092,7 @@ void QCPAbstractPlottable::setName(const QString &name)
 void QCPAbstractPlottable::setAntialiasedFill(bool enabled)
 {
   mAntialiasedFill = enabled;
+  markDirty();
 }
 
 /*!
@@ -10757,6 +12104,7 @@ void QCPAbstractPlottable::setAntialiasedFill(bool enabled)
 void QCPAbstractPlottable::setAntialiasedScatters(bool enabled)
 {
   mAntialiasedScatters = enabled;
+  markDirty();
 }
 
 /*!
@@ -10770,6 +12118,7 @@ void QCPAbstractPlottable::setAntialiasedScatters(bool enabled)
 void QCPAbstractPlottable::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -10784,6 +12133,7 @@ void QCPAbstractPlottable::setPen(const QPen &pen)
 void QCPAbstractPlottable::setBrush(const QBrush &brush)
 {
   mBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -10799,7 +12149,9 @@ void QCPAbstractPlottable::setBrush(const QBrush &brush)
 */
 void QCPAbstractPlottable::setKeyAxis(QCPAxis *axis)
 {
+  markDirty(); // the old axis rect must be repainted, too
   mKeyAxis = axis;
+  markDirty();
 }
 
 /*!
@@ -10815,7 +12167,9 @@ void QCPAbstractPlottable::setKeyAxis(QCPAxis *axis)
 */
 void QCPAbstractPlottable::setValueAxis(QCPAxis *axis)
 {
+  markDirty(); // the old axis rect must be repainted, too
   mValueAxis = axis;
+  markDirty();
 }
 
 
@@ -10843,6 +12197,7 @@ void QCPAbstractPlottable::setSelection(QCPDataSelection selection)
   if (mSelection != selection)
   {
     mSelection = selection;
+    markDirty();
     emit selectionChanged(selected());
     emit selectionChanged(mSelection);
   }
@@ -10872,6 +12227,7 @@ void QCPAbstractPlottable::setSelectionDecorator(QCPSelectionDecorator *decorato
     delete mSelectionDecorator;
     mSelectionDecorator = 0;
   }
+  markDirty();
 }
 
 /*!
@@ -10894,6 +12250,7 @@ void QCPAbstractPlottable::setSelectable(QCP::SelectionType selectable)
     emit selectableChanged(mSelectable);
     if (mSelection != oldSelection)
     {
+      markDirty();
       emit selectionChanged(selected());
       emit selectionChanged(mSelection);
     }
@@ -11164,6 +12521,26 @@ bool QCPAbstractPlottable::removeFromLegend() const
     return removeFromLegend(mParentPlot->legend);
 }
 
+/*!
+  Marks the layer of this plottable as dirty, like \ref QCPLayerable::markDirty. The legend items
+  of this plottable (see \ref addToLegend) show its name and appearance, so their layers are marked
+  dirty as well, with the rect of the respective legend item. This way, legends outside the clip
+  rect of the plottable are repainted on the widget, too.
+*/
+void QCPAbstractPlottable::markDirty()
+{
+  QCPLayerable::markDirty();
+  if (!mParentPlot || !mParentPlot->plotLayout())
+    return;
+  const QList<QCPLayoutElement*> elements = mParentPlot->plotLayout()->elements(true);
+  for (int i=0; i<elements.size(); ++i)
+  {
+    QCPPlottableLegendItem *legendItem = qobject_cast<QCPPlottableLegendItem*>(elements.at(i));
+    if (legendItem && legendItem->plottable() == this && legendItem->layer())
+      legendItem->layer()->markDirty(legendItem->outerRect().adjusted(-1, -1, 1, 1)); // margin for antialiased icon and text edges
+  }
+}
+
 /* inherits documentation from base class */
 QRect QCPAbstractPlottable::clipRect() const
 {
@@ -11590,6 +12967,7 @@ void QCPItemPosition::setTypeX(QCPItemPosition::PositionType type)
       pixel = pixelPosition();
     
     mPositionTypeX = type;
+    mParentItem->markDirty();
     
     if (retainPixelPosition)
       setPixelPosition(pixel);
@@ -11620,6 +12998,7 @@ void QCPItemPosition::setTypeY(QCPItemPosition::PositionType type)
       pixel = pixelPosition();
     
     mPositionTypeY = type;
+    mParentItem->markDirty();
     
     if (retainPixelPosition)
       setPixelPosition(pixel);
@@ -11708,6 +13087,7 @@ bool QCPItemPosition::setParentAnchorX(QCPItemAnchor *parentAnchor, bool keepPix
   if (parentAnchor)
     parentAnchor->addChildX(this);
   mParentAnchorX = parentAnchor;
+  mParentItem->markDirty();
   // restore pixel position under new parent:
   if (keepPixelPosition)
     setPixelPosition(pixelP);
@@ -11773,6 +13153,7 @@ bool QCPItemPosition::setParentAnchorY(QCPItemAnchor *parentAnchor, bool keepPix
   if (parentAnchor)
     parentAnchor->addChildY(this);
   mParentAnchorY = parentAnchor;
+  mParentItem->markDirty();
   // restore pixel position under new parent:
   if (keepPixelPosition)
     setPixelPosition(pixelP);
@@ -11802,6 +13183,7 @@ void QCPItemPosition::setCoords(double key, double value)
 {
   mKey = key;
   mValue = value;
+  mParentItem->markDirty();
 }
 
 /*! \overload
@@ -11924,6 +13306,7 @@ void QCPItemPosition::setAxes(QCPAxis *keyAxis, QCPAxis *valueAxis)
 {
   mKeyAxis = keyAxis;
   mValueAxis = valueAxis;
+  mParentItem->markDirty();
 }
 
 /*!
@@ -11934,6 +13317,7 @@ void QCPItemPosition::setAxes(QCPAxis *keyAxis, QCPAxis *valueAxis)
 void QCPItemPosition::setAxisRect(QCPAxisRect *axisRect)
 {
   mAxisRect = axisRect;
+  mParentItem->markDirty();
 }
 
 /*!
@@ -12239,6 +13623,39 @@ QCPAxisRect *QCPAbstractItem::clipAxisRect() const
   return mClipAxisRect.data();
 }
 
+/*!
+  Marks the layer of this item as dirty, like \ref QCPLayerable::markDirty. Items with positions
+  that have an anchor of this item as parent anchor (see \ref QCPItemPosition::setParentAnchor)
+  move along with this item, so they are marked dirty as well, including their own dependent items.
+*/
+void QCPAbstractItem::markDirty()
+{
+  QCPLayerable::markDirty();
+  QList<QCPAbstractItem*> pendingItems;
+  QSet<QCPAbstractItem*> markedItems;
+  pendingItems << this;
+  markedItems << this;
+  while (!pendingItems.isEmpty())
+  {
+    QCPAbstractItem *item = pendingItems.takeLast();
+    foreach (QCPItemAnchor *anchor, item->mAnchors)
+    {
+      QSet<QCPItemPosition*> children = anchor->mChildrenX;
+      children.unite(anchor->mChildrenY);
+      foreach (QCPItemPosition *child, children)
+      {
+        QCPAbstractItem *childItem = child->mParentItem;
+        if (!markedItems.contains(childItem)) // anchors of one item may depend on each other, and items may depend on each other mutually via different anchors
+        {
+          childItem->QCPLayerable::markDirty();
+          markedItems << childItem;
+          pendingItems << childItem;
+        }
+      }
+    }
+  }
+}
+
 /*!
   Sets whether the item shall be clipped to an axis rect or whether it shall be visible on the
   entire QCustomPlot. The axis rect can be set with \ref setClipAxisRect.
@@ -12247,9 +13664,11 @@ QCPAxisRect *QCPAbstractItem::clipAxisRect() const
 */
 void QCPAbstractItem::setClipToAxisRect(bool clip)
 {
+  markDirty(); // the clip rect changes, so the old one must be repainted, too
   mClipToAxisRect = clip;
   if (mClipToAxisRect)
     setParentLayerable(mClipAxisRect.data());
+  markDirty();
 }
 
 /*!
@@ -12260,9 +13679,11 @@ void QCPAbstractItem::setClipToAxisRect(bool clip)
 */
 void QCPAbstractItem::setClipAxisRect(QCPAxisRect *rect)
 {
+  markDirty(); // the clip rect changes, so the old one must be repainted, too
   mClipAxisRect = rect;
   if (mClipToAxisRect)
     setParentLayerable(mClipAxisRect.data());
+  markDirty();
 }
 
 /*!
@@ -12302,6 +13723,7 @@ void QCPAbstractItem::setSelected(bool selected)
   if (mSelected != selected)
   {
     mSelected = selected;
+    markDirty();
     emit selectionChanged(mSelected);
   }
 }
@@ -12579,6 +14001,23 @@ QCP::Interaction QCPAbstractItem::selectionCategory() const
   one cell with the main QCPAxisRect inside.
 */
 
+/*! \fn int QCustomPlot::replotCount() const
+  
+  Returns the number of replots that were actually performed since construction or the last call
+  of \ref resetReplotCounters.
+  
+  \see mergedReplotCount, setMaximumFrameRate
+*/
+
+/*! \fn int QCustomPlot::mergedReplotCount() const
+  
+  Returns the number of replot requests that didn't cause a replot of their own, because they were
+  merged into an already scheduled replot (see \ref setMaximumFrameRate and \ref
+  rpQueuedReplot). The counter is reset with \ref resetReplotCounters.
+  
+  \see replotCount
+*/
+
 /* end of documentation of inline functions */
 /* start of documentation of signals */
 
@@ -12880,11 +14319,19 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mSelectionRectMode(QCP::srmNone),
   mSelectionRect(0),
   mOpenGl(false),
+  mMaximumFrameRate(0),
+  mBackgroundRendering(false),
+  mPaintBufferType(pbtPixmap),
   mMouseHasMoved(false),
   mMouseEventLayerable(0),
   mMouseSignalLayerable(0),
   mReplotting(false),
   mReplotQueued(false),
+  mReplotSerial(0),
+  mFrameTimer(new QTimer(this)),
+  mReplotCount(0),
+  mMergedReplotCount(0),
+  mRenderThreadPool(new QThreadPool(this)),
   mOpenGlMultisamples(16),
   mOpenGlAntialiasedElementsBackup(QCP::aeNone),
   mOpenGlCacheLabelsBackup(true)
@@ -12893,6 +14340,11 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   setAttribute(Qt::WA_OpaquePaintEvent);
   setFocusPolicy(Qt::ClickFocus);
   setMouseTracking(true);
+  mFrameTimer->setSingleShot(true);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+  mFrameTimer->setTimerType(Qt::PreciseTimer); // a coarse timer may fire early, which would defer the frame by another timer round-trip
+#endif
+  connect(mFrameTimer, SIGNAL(timeout()), this, SLOT(replot()));
   QLocale currentLocale = locale();
   currentLocale.setNumberOptions(QLocale::OmitGroupSeparator);
   setLocale(currentLocale);
@@ -12955,6 +14407,7 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
 
 QCustomPlot::~QCustomPlot()
 {
+  mRenderThreadPool->waitForDone(); // a running render task must not outlive the members it's referenced by
   clearPlottables();
   clearItems();
 
@@ -13356,6 +14809,7 @@ void QCustomPlot::setOpenGl(bool enabled, int multisampling)
   }
   // recreate all paint buffers:
   mPaintBuffers.clear();
+  mPaintBufferPool.clear();
   setupPaintBuffers();
 #else
   Q_UNUSED(enabled)
@@ -13363,6 +14817,96 @@ void QCustomPlot::setOpenGl(bool enabled, int multisampling)
 #endif
 }
 
+/*!
+  Limits the number of replots per second to \a framesPerSecond. A value of zero (the default)
+  disables the limit.
+  
+  If a limit is set, calls of \ref replot that arrive sooner than <tt>1/framesPerSecond</tt> after
+  the start of the previous replot don't replot immediately. Instead, a single replot is scheduled
+  for the time the next frame is due, and all further requests until then are merged into it. So
+  user interaction handlers which replot on every mouse event don't cause more replots than can be
+  displayed. Calls with \ref rpQueuedReplot are always deferred to the next due frame, calls with
+  \ref rpImmediateRefresh bypass the limit and replot immediately.
+  
+  To limit replots to the refresh rate of the display, pass the refresh rate of the screen, e.g.
+  <tt>QGuiApplication::primaryScreen()->refreshRate()</tt>.
+  
+  The number of performed and merged replots can be retrieved with \ref replotCount and \ref
+  mergedReplotCount.
+*/
+void QCustomPlot::setMaximumFrameRate(double framesPerSecond)
+{
+  mMaximumFrameRate = qMax(0.0, framesPerSecond);
+}
+
+/*!
+  Sets whether the layers are rasterized on a worker thread, so the GUI thread stays responsive
+  while plots with a lot of data are drawn.
+  
+  If enabled, \ref replot still updates the layout and lets all layers draw themselves on the GUI
+  thread, but their painting commands are only recorded into a QPicture per paint buffer. These
+  pictures are immutable snapshots of the plot's state at the time of the replot, the actual
+  rasterization into QImage based paint buffers (\ref QCPPaintBufferImage) happens on a worker
+  thread. Until it is finished, the widget keeps showing the previous content of the buffers. The
+  finished buffers are then composited in the paint event. Replots that happen while the worker is
+  busy are merged, so only the most recent state is rasterized next.
+  
+  An exception is a change of the buffer size, e.g. when the widget is resized or its device pixel
+  ratio changes: the paint buffers are then reallocated and cleared, so the plot area may stay
+  blank for a frame until the worker has delivered the new content.
+  
+  Since the widget is updated asynchronously, the plot shown directly after \ref replot returns may
+  still be the previous one. Exports like \ref savePng or \ref toPixmap are not affected, they
+  always draw synchronously.
+  
+  Background rendering isn't used while OpenGL is enabled (\ref setOpenGl), because the OpenGL
+  paint buffers are bound to the GUI thread's context.
+  
+  \note Pixmaps drawn by layerables (e.g. the axis rect background, \ref QCPItemPixmap or pixmap
+  scatter styles) are rasterized on the worker thread as well. This requires a platform that
+  supports the use of pixmaps in threads, which is the case for all common desktop platforms with Qt
+  5. Label caching (\ref QCP::phCacheLabels) is not used for the recorded pictures.
+*/
+void QCustomPlot::setBackgroundRendering(bool enabled)
+{
+  if (mBackgroundRendering != enabled)
+  {
+    mBackgroundRendering = enabled;
+    mRenderThreadPool->waitForDone();
+    mRunningRenderTask.clear();
+    mPendingRenderTask.clear();
+    // recreate all paint buffers:
+    mPaintBuffers.clear();
+    mPaintBufferPool.clear();
+    setupPaintBuffers();
+  }
+}
+
+/*!
+  Sets which paint buffer implementation is used by the software rasterizer, i.e. when OpenGL is
+  disabled (\ref setOpenGl).
+  
+  The default \ref pbtPixmap uses QPixmap based buffers (\ref QCPPaintBufferPixmap). With \ref
+  pbtImage, QImage based buffers (\ref QCPPaintBufferImage) are used. They don't depend on the
+  windowing system, are composited in the paint event by only blitting the exposed region, and
+  allow \ref toImage to reuse the rendered buffers instead of drawing the plot again, under the
+  conditions described there. When \ref setBackgroundRendering is enabled, image buffers are used
+  regardless of this setting.
+  
+  Changing the type recreates all paint buffers, so the next \ref replot redraws all layers.
+*/
+void QCustomPlot::setPaintBufferType(QCustomPlot::PaintBufferType type)
+{
+  if (mPaintBufferType != type)
+  {
+    mPaintBufferType = type;
+    // recreate all paint buffers:
+    mPaintBuffers.clear();
+    mPaintBufferPool.clear();
+    setupPaintBuffers();
+  }
+}
+
 /*!
   Sets the viewport of this QCustomPlot. Usually users of QCustomPlot don't need to change the
   viewport manually.
@@ -14170,14 +15714,125 @@ bool QCustomPlot::moveLayer(QCPLayer *layer, QCPLayer *otherLayer, QCustomPlot::
   else if (layer->index() < otherLayer->index())
     mLayers.move(layer->index(), otherLayer->index() + (insertMode==limAbove ? 0:-1));
   
-  // invalidate the paint buffers that are responsible for the layers:
-  if (!layer->mPaintBuffer.isNull())
-    layer->mPaintBuffer.data()->setInvalidated();
-  if (!otherLayer->mPaintBuffer.isNull())
-    otherLayer->mPaintBuffer.data()->setInvalidated();
+  // invalidate the paint buffers that are responsible for the layers:
+  if (!layer->mPaintBuffer.isNull())
+    layer->mPaintBuffer.data()->setInvalidated();
+  if (!otherLayer->mPaintBuffer.isNull())
+    otherLayer->mPaintBuffer.data()->setInvalidated();
+  
+  updateLayerIndices();
+  return true;
+}
+
+/*!
+  Returns the layer named "overlay", which is the topmost layer and in mode \ref
+  QCPLayer::lmBuffered in a new QCustomPlot instance. If no such layer exists (because it was
+  removed), a new buffered layer with that name is created on top of all other layers.
+  
+  \see moveToOverlay, replotOverlay
+*/
+QCPLayer *QCustomPlot::overlayLayer()
+{
+  QCPLayer *overlay = layer(QLatin1String("overlay"));
+  if (!overlay)
+  {
+    addLayer(QLatin1String("overlay"), mLayers.last(), limAbove);
+    overlay = layer(QLatin1String("overlay"));
+    overlay->setMode(QCPLayer::lmBuffered);
+  }
+  return overlay;
+}
+
+/*!
+  Moves \a layerable to the \ref overlayLayer and remembers the layer it was on before, so it can
+  be moved back with \ref moveFromOverlay.
+  
+  This is meant for objects that change frequently during user interaction, for example items that
+  are dragged with the mouse. While they are on the overlay layer, \ref replotOverlay redraws only
+  the overlay layer instead of all plottables, so the cost of the interactive feedback is
+  independent of the amount of data in the plot.
+  
+  Returns true on success, i.e. if \a layerable belongs to this QCustomPlot.
+*/
+bool QCustomPlot::moveToOverlay(QCPLayerable *layerable)
+{
+  if (!layerable || layerable->parentPlot() != this)
+  {
+    qDebug() << Q_FUNC_INFO << "layerable not part of this QCustomPlot:" << reinterpret_cast<quintptr>(layerable);
+    return false;
+  }
+  QCPLayer *overlay = overlayLayer();
+  if (layerable->layer() == overlay)
+    return true;
+  
+  // forget entries of deleted layerables:
+  for (int i=mOverlayOrigins.size()-1; i>=0; --i)
+  {
+    if (mOverlayOrigins.at(i).first.isNull())
+      mOverlayOrigins.removeAt(i);
+  }
+  mOverlayOrigins.append(qMakePair(QPointer<QCPLayerable>(layerable), QPointer<QCPLayer>(layerable->layer())));
+  return layerable->setLayer(overlay);
+}
+
+/*!
+  Moves \a layerable back to the layer it was on before it was moved to the overlay layer with \ref
+  moveToOverlay. If that layer was removed in the meantime, \a layerable is moved to the \ref
+  currentLayer.
+  
+  Returns false if \a layerable wasn't moved to the overlay layer with \ref moveToOverlay.
+*/
+bool QCustomPlot::moveFromOverlay(QCPLayerable *layerable)
+{
+  for (int i=0; i<mOverlayOrigins.size(); ++i)
+  {
+    if (mOverlayOrigins.at(i).first.data() == layerable && layerable)
+    {
+      QCPLayer *origin = mOverlayOrigins.at(i).second.data();
+      mOverlayOrigins.removeAt(i);
+      return layerable->setLayer(origin ? origin : mCurrentLayer);
+    }
+  }
+  qDebug() << Q_FUNC_INFO << "layerable wasn't moved to the overlay layer:" << reinterpret_cast<quintptr>(layerable);
+  return false;
+}
+
+/*!
+  Redraws only the \ref overlayLayer via \ref QCPLayer::replot, if that is sufficient to bring the
+  plot up to date. Otherwise, a full \ref replot is performed instead.
+  
+  Whether the other layers are up to date is decided by their dirty flags (see \ref
+  QCPLayer::markDirty), so this is only done if the plotting hint \ref QCP::phSkipCleanLayers is
+  set, which requires changes not covered by the automatic dirty tracking to be marked manually.
+  Without the hint, this method always performs a full replot. With the hint, a full replot is
+  performed if any of the following applies:
+  \li any layer other than the overlay layer is dirty, e.g. because an object was moved from or to
+  the overlay layer, or because a plottable took data from its data queue (see \ref
+  QCPAbstractPlottable1D::setDataQueue), which is checked by this method
+  \li axis ranges, the layout or the viewport changed since the last replot
+  \li the overlay layer isn't in mode \ref QCPLayer::lmBuffered
+  
+  If only the overlay layer is redrawn, the signals \ref beforeReplot and \ref afterReplot are not
+  emitted, like with \ref QCPLayer::replot. Changes that are made in response to \ref beforeReplot
+  therefore don't take effect until the next full replot.
   
-  updateLayerIndices();
-  return true;
+  \see moveToOverlay
+*/
+void QCustomPlot::replotOverlay()
+{
+  QCPLayer *overlay = overlayLayer();
+  foreach (QCPAbstractPlottable *plottable, mPlottables) // marks the plottables dirty if they received new data
+    plottable->takeQueuedData();
+  bool fullReplot = !mPlottingHints.testFlag(QCP::phSkipCleanLayers) || overlay->mode() != QCPLayer::lmBuffered || hasInvalidatedPaintBuffers() || frameSignature() != mFrameSignature;
+  foreach (QCPLayer *layer, mLayers)
+  {
+    if (layer != overlay && layer->dirty())
+      fullReplot = true;
+  }
+  if (fullReplot)
+    replot();
+  else
+    overlay->replot();
 }
 
 /*!
@@ -14420,16 +16075,39 @@ void QCustomPlot::deselectAll()
   If a layer is in mode \ref QCPLayer::lmBuffered (\ref QCPLayer::setMode), it is also possible to
   replot only that specific layer via \ref QCPLayer::replot. See the documentation there for
   details.
+  
+  If a maximum frame rate is set with \ref setMaximumFrameRate, replots that are requested too soon
+  after the previous one are deferred and merged, see the documentation there.
+  
+  If the plotting hint \ref QCP::phSkipCleanLayers is set, only the region of the widget that was
+  changed by the dirty layers is repainted afterwards, e.g. a single axis rect when only its
+  plottables changed (see \ref QCPLayer::markDirty(const QRect &rect)).
 */
 void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
 {
-  if (refreshPriority == QCustomPlot::rpQueuedReplot)
+  if (mMaximumFrameRate > 0 && refreshPriority != QCustomPlot::rpImmediateRefresh)
+  {
+    if (mReplotting) // don't schedule another frame for signals looping back to replot slot
+      return;
+    const qint64 frameInterval = qMax(qint64(1), qRound64(1000.0/mMaximumFrameRate));
+    const bool timerDue = sender() == mFrameTimer; // the frame timer fires when the frame is due, even if the clocks disagree slightly
+    const qint64 remaining = mFrameClock.isValid() && !timerDue ? qMax(qint64(0), frameInterval-mFrameClock.elapsed()) : 0;
+    if (remaining > 0 || refreshPriority == QCustomPlot::rpQueuedReplot)
+    {
+      if (mFrameTimer->isActive())
+        ++mMergedReplotCount;
+      else
+        mFrameTimer->start(int(remaining));
+      return;
+    }
+  } else if (refreshPriority == QCustomPlot::rpQueuedReplot)
   {
     if (!mReplotQueued)
     {
       mReplotQueued = true;
       QTimer::singleShot(0, this, SLOT(replot()));
-    }
+    } else
+      ++mMergedReplotCount;
     return;
   }
   
@@ -14437,25 +16115,91 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
     return;
   mReplotting = true;
   mReplotQueued = false;
+  mFrameTimer->stop(); // a scheduled replot is satisfied by this one
+  mFrameClock.start();
+  ++mReplotCount;
+  static uint lastReplotSerial = 0; // shared by all QCustomPlot instances, so a data column shared across plots never sees the same serial for different replots
+  if (++lastReplotSerial == 0) // zero is reserved for "no replot in progress", see QCPDataColumn::cachedLowerBound
+    lastReplotSerial = 1;
+  mReplotSerial = lastReplotSerial;
+  foreach (QCPAbstractPlottable *plottable, mPlottables)
+    plottable->takeQueuedData();
   emit beforeReplot();
   
   updateLayout();
   // draw all layered objects (grid, axes, plottables, items, legend,...) into their buffers:
   setupPaintBuffers();
+  if (updateFrameSignature() || !mPlottingHints.testFlag(QCP::phSkipCleanLayers))
+  {
+    foreach (QCPLayer *layer, mLayers)
+      layer->markDirty();
+  }
+  // buffers that were invalidated by setupPaintBuffers or layer changes affect the entire viewport,
+  // otherwise only the dirty regions of the layers need to be repainted on the widget:
+  QRegion damage = hasInvalidatedPaintBuffers() ? QRegion(mViewport) : QRegion();
+  // a paint buffer is redrawn entirely if any of its layers is dirty, the others keep their content:
   foreach (QCPLayer *layer, mLayers)
-    layer->drawToPaintBuffer();
+  {
+    if (layer->mDirty)
+    {
+      damage += layer->dirtyRegion();
+      if (!layer->mPaintBuffer.isNull())
+        layer->mPaintBuffer.data()->setInvalidated();
+    }
+  }
+  QList<QSharedPointer<QCPAbstractPaintBuffer> > invalidatedBuffers;
+  for (int i=0; i<mPaintBuffers.size(); ++i)
+  {
+    if (mPaintBuffers.at(i)->invalidated())
+      invalidatedBuffers.append(mPaintBuffers.at(i));
+  }
+  if (renderingInBackground())
+  {
+    // buffers keep showing their previous content until the worker thread has rasterized the new one:
+    for (int i=0; i<invalidatedBuffers.size(); ++i)
+      queueBackgroundRendering(invalidatedBuffers.at(i));
+    mPendingRenderDamage += damage;
+    damage = QRegion(); // repainted when the rendering has finished, see backgroundRenderingFinished
+    startBackgroundRendering();
+    foreach (QCPLayer *layer, mLayers)
+      layer->markClean();
+  } else if (!mOpenGl && ((mPlottingHints.testFlag(QCP::phParallelLayers) && invalidatedBuffers.size() > 1) || mPlottingHints.testFlag(QCP::phParallelAxisRects)))
+  {
+    renderInParallel(invalidatedBuffers);
+    foreach (QCPLayer *layer, mLayers)
+      layer->markClean();
+  } else
+  {
+    for (int i=0; i<invalidatedBuffers.size(); ++i)
+      invalidatedBuffers.at(i)->clear(Qt::transparent);
+    foreach (QCPLayer *layer, mLayers)
+    {
+      if (layer->mPaintBuffer.isNull() || layer->mPaintBuffer.data()->invalidated())
+        layer->drawToPaintBuffer();
+      layer->markClean();
+    }
+  }
   for (int i=0; i<mPaintBuffers.size(); ++i)
     mPaintBuffers.at(i)->setInvalidated(false);
   
   if ((refreshPriority == rpRefreshHint && mPlottingHints.testFlag(QCP::phImmediateRefresh)) || refreshPriority==rpImmediateRefresh)
-    repaint();
+    repaint(damage);
   else
-    update();
+    update(damage);
   
   emit afterReplot();
   mReplotting = false;
 }
 
+/*!
+  Resets the counters returned by \ref replotCount and \ref mergedReplotCount to zero.
+*/
+void QCustomPlot::resetReplotCounters()
+{
+  mReplotCount = 0;
+  mMergedReplotCount = 0;
+}
+
 /*!
   Rescales the axes such that all plottables (like graphs) in the plot are fully visible.
   
@@ -14745,7 +16489,6 @@ QSize QCustomPlot::sizeHint() const
 */
 void QCustomPlot::paintEvent(QPaintEvent *event)
 {
-  Q_UNUSED(event);
   QCPPainter painter(this);
   if (painter.isActive())
   {
@@ -14753,8 +16496,19 @@ void QCustomPlot::paintEvent(QPaintEvent *event)
     if (mBackgroundBrush.style() != Qt::NoBrush)
       painter.fillRect(mViewport, mBackgroundBrush);
     drawBackground(&painter);
+    // only blit the exposed parts of the buffers, which after a replot are the damaged regions (see replot):
+    QVector<QRect> exposedRects;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    for (QRegion::const_iterator it=event->region().begin(); it!=event->region().end(); ++it)
+      exposedRects.append(*it);
+#else
+    exposedRects = event->region().rects();
+#endif
     for (int bufferIndex = 0; bufferIndex < mPaintBuffers.size(); ++bufferIndex)
-      mPaintBuffers.at(bufferIndex)->draw(&painter);
+    {
+      for (int i=0; i<exposedRects.size(); ++i)
+        mPaintBuffers.at(bufferIndex)->drawPart(&painter, exposedRects.at(i));
+    }
   }
 }
 
@@ -15020,13 +16774,23 @@ void QCustomPlot::draw(QCPPainter *painter)
 
   Here, the layout elements calculate their positions and margins, and prepare for the following
   draw call.
+  
+  If the plotting hint \ref QCP::phSkipUnchangedLayout is set, only the preparation phase (which
+  e.g. generates the axis ticks) is run if the \ref layoutSignature is the same as after the
+  previous layout pass. The margins and element rects would then come out unchanged anyway.
 */
 void QCustomPlot::updateLayout()
 {
   // run through layout phases:
   mPlotLayout->update(QCPLayoutElement::upPreparation);
+  if (mPlottingHints.testFlag(QCP::phSkipUnchangedLayout) && !mLayoutSignature.isEmpty() && layoutSignature() == mLayoutSignature)
+    return;
   mPlotLayout->update(QCPLayoutElement::upMargins);
   mPlotLayout->update(QCPLayoutElement::upLayout);
+  if (mPlottingHints.testFlag(QCP::phSkipUnchangedLayout))
+    mLayoutSignature = layoutSignature();
+  else
+    mLayoutSignature.clear();
 }
 
 /*! \internal
@@ -15078,10 +16842,13 @@ void QCustomPlot::drawBackground(QCPPainter *painter)
   QCPLayer::lmLogical layers to a mutual paint buffer and creates dedicated paint buffers for
   layers in \ref QCPLayer::lmBuffered mode.
 
-  This method uses \ref createPaintBuffer to create new paint buffers.
+  This method uses \ref takePaintBuffer to obtain new paint buffers. Paint buffers that are no
+  longer needed are kept in a pool for later reuse.
 
-  After this method, the paint buffers are empty (filled with \c Qt::transparent) and invalidated
-  (so an attempt to replot only a single buffered layer causes a full replot).
+  Paint buffers that were newly created, resized, or associated with a different set of layers are
+  invalidated (so an attempt to replot only a single buffered layer causes a full replot). The
+  remaining paint buffers keep their content, \ref replot decides which of them need to be cleared
+  and redrawn.
 
   This method is called in every \ref replot call, prior to actually drawing the layers (into their
   associated paint buffer). If the paint buffers don't need changing/reallocating, this method
@@ -15091,46 +16858,185 @@ void QCustomPlot::setupPaintBuffers()
 {
   int bufferIndex = 0;
   if (mPaintBuffers.isEmpty())
-    mPaintBuffers.append(QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer()));
+    mPaintBuffers.append(takePaintBuffer());
   
   for (int layerIndex = 0; layerIndex < mLayers.size(); ++layerIndex)
   {
     QCPLayer *layer = mLayers.at(layerIndex);
     if (layer->mode() == QCPLayer::lmLogical)
     {
-      layer->mPaintBuffer = mPaintBuffers.at(bufferIndex).toWeakRef();
+      assignPaintBuffer(layer, mPaintBuffers.at(bufferIndex));
     } else if (layer->mode() == QCPLayer::lmBuffered)
     {
       ++bufferIndex;
       if (bufferIndex >= mPaintBuffers.size())
-        mPaintBuffers.append(QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer()));
-      layer->mPaintBuffer = mPaintBuffers.at(bufferIndex).toWeakRef();
+        mPaintBuffers.append(takePaintBuffer());
+      assignPaintBuffer(layer, mPaintBuffers.at(bufferIndex));
       if (layerIndex < mLayers.size()-1 && mLayers.at(layerIndex+1)->mode() == QCPLayer::lmLogical) // not last layer, and next one is logical, so prepare another buffer for next layerables
       {
         ++bufferIndex;
         if (bufferIndex >= mPaintBuffers.size())
-          mPaintBuffers.append(QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer()));
+          mPaintBuffers.append(takePaintBuffer());
       }
     }
   }
-  // remove unneeded buffers:
+  // move unneeded buffers to the pool, so they can be reused when the layer modes change again:
   while (mPaintBuffers.size()-1 > bufferIndex)
-    mPaintBuffers.removeLast();
-  // resize buffers to viewport size and clear contents:
+    mPaintBufferPool.append(mPaintBuffers.takeLast());
+  // resize buffers to viewport size, resized buffers lose their content:
   for (int i=0; i<mPaintBuffers.size(); ++i)
   {
-    mPaintBuffers.at(i)->setSize(viewport().size()); // won't do anything if already correct size
-    mPaintBuffers.at(i)->clear(Qt::transparent);
-    mPaintBuffers.at(i)->setInvalidated();
+    if (mPaintBuffers.at(i)->size() != viewport().size())
+    {
+      mPaintBuffers.at(i)->setSize(viewport().size());
+      mPaintBuffers.at(i)->setInvalidated();
+    }
+  }
+}
+
+/*! \internal
+  
+  Associates \a layer with the paint buffer \a buffer. If the layer was previously drawn on a
+  different buffer, \a buffer is invalidated, because its content doesn't include the layer yet.
+  
+  \see setupPaintBuffers
+*/
+void QCustomPlot::assignPaintBuffer(QCPLayer *layer, const QSharedPointer<QCPAbstractPaintBuffer> &buffer)
+{
+  if (layer->mPaintBuffer.data() != buffer.data())
+  {
+    layer->mPaintBuffer = buffer.toWeakRef();
+    buffer->setInvalidated();
+  }
+}
+
+/*! \internal
+  
+  Collects the properties that affect the appearance of all layers: the viewport, the device pixel
+  ratio, the antialiasing settings, the geometry of all layout elements and the ranges of all axes
+  in the layout. The viewport background is included as well, because it is repainted together
+  with the layers (see \ref replot).
+  
+  \see updateFrameSignature
+*/
+QVector<double> QCustomPlot::frameSignature() const
+{
+  QVector<double> signature;
+  signature << mViewport.left() << mViewport.top() << mViewport.width() << mViewport.height() << mBufferDevicePixelRatio
+            << int(mAntialiasedElements) << int(mNotAntialiasedElements)
+            << mBackgroundBrush.style() << mBackgroundBrush.color().rgba() << mBackgroundPixmap.cacheKey() << mBackgroundScaled << mBackgroundScaledMode;
+  const QList<QCPLayoutElement*> elements = mPlotLayout->elements(true);
+  for (int i=0; i<elements.size(); ++i)
+  {
+    QCPLayoutElement *element = elements.at(i);
+    if (!element) // empty cells of layout grids
+      continue;
+    signature << element->outerRect().left() << element->outerRect().top() << element->outerRect().width() << element->outerRect().height()
+              << element->rect().left() << element->rect().top() << element->rect().width() << element->rect().height();
+    QList<QCPAxis*> axes;
+    if (QCPAxisRect *axisRect = qobject_cast<QCPAxisRect*>(element))
+      axes = axisRect->axes();
+    else if (QCPColorScale *colorScale = qobject_cast<QCPColorScale*>(element))
+      axes << colorScale->axis();
+    for (int k=0; k<axes.size(); ++k)
+    {
+      if (QCPAxis *axis = axes.at(k))
+        signature << axis->range().lower << axis->range().upper << axis->scaleType() << axis->rangeReversed();
+    }
+  }
+  return signature;
+}
+
+/*! \internal
+  
+  Compares the \ref frameSignature with the one of the previous call and returns true if it
+  changed.
+  
+  If the plotting hint \ref QCP::phSkipCleanLayers is set, \ref replot redraws all layers when this
+  method returns true, and only the dirty layers otherwise (see \ref QCPLayer::markDirty).
+*/
+bool QCustomPlot::updateFrameSignature()
+{
+  const QVector<double> signature = frameSignature();
+  const bool changed = signature != mFrameSignature;
+  mFrameSignature = signature;
+  return changed;
+}
+
+/*! \internal
+  
+  Collects the inputs and results of the margin and layout phases of the layout system: the
+  viewport, the structure of the layout tree, the size constraints, margins and rects of all layout
+  elements, the size hints of elements that aren't layouts themselves (e.g. legend items and text
+  elements), the spacing and stretch factors of grid layouts, the inset placements of inset layouts
+  and the margins needed by all axes.
+  
+  The axis margins come from the margin cache of each axis, so they are only measured again if the
+  tick labels, fonts, etc. changed. This method must be called after the preparation phase, which
+  updates the tick labels.
+  
+  \see updateLayout
+*/
+QVector<double> QCustomPlot::layoutSignature()
+{
+  QVector<double> signature;
+  signature << mViewport.left() << mViewport.top() << mViewport.width() << mViewport.height();
+  QList<QCPLayoutElement*> elements = mPlotLayout->elements(true);
+  elements.prepend(mPlotLayout);
+  for (int i=0; i<elements.size(); ++i)
+  {
+    QCPLayoutElement *element = elements.at(i);
+    signature << double(quintptr(element));
+    if (!element) // empty cells of layout grids
+      continue;
+    signature << element->outerRect().left() << element->outerRect().top() << element->outerRect().width() << element->outerRect().height()
+              << element->margins().left() << element->margins().top() << element->margins().right() << element->margins().bottom()
+              << element->minimumMargins().left() << element->minimumMargins().top() << element->minimumMargins().right() << element->minimumMargins().bottom()
+              << int(element->autoMargins()) << element->sizeConstraintRect()
+              << element->minimumSize().width() << element->minimumSize().height() << element->maximumSize().width() << element->maximumSize().height()
+              << double(quintptr(element->marginGroup(QCP::msLeft))) << double(quintptr(element->marginGroup(QCP::msRight)))
+              << double(quintptr(element->marginGroup(QCP::msTop))) << double(quintptr(element->marginGroup(QCP::msBottom)));
+    QList<QCPAxis*> axes;
+    if (QCPLayoutGrid *grid = qobject_cast<QCPLayoutGrid*>(element))
+    {
+      signature << grid->rowCount() << grid->columnCount() << grid->rowSpacing() << grid->columnSpacing();
+      signature << grid->rowStretchFactors().toVector() << grid->columnStretchFactors().toVector();
+    } else if (QCPLayoutInset *inset = qobject_cast<QCPLayoutInset*>(element))
+    {
+      for (int k=0; k<inset->elementCount(); ++k)
+      {
+        const QRectF insetRect = inset->insetRect(k);
+        signature << inset->insetPlacement(k) << int(inset->insetAlignment(k)) << insetRect.left() << insetRect.top() << insetRect.width() << insetRect.height();
+      }
+    } else if (!qobject_cast<QCPLayout*>(element))
+    {
+      // the size hints of layouts are derived from their children, which are already part of the signature
+      const QSize minimumHint = element->minimumOuterSizeHint();
+      const QSize maximumHint = element->maximumOuterSizeHint();
+      signature << minimumHint.width() << minimumHint.height() << maximumHint.width() << maximumHint.height();
+      if (QCPAxisRect *axisRect = qobject_cast<QCPAxisRect*>(element))
+        axes = axisRect->axes();
+      else if (QCPColorScale *colorScale = qobject_cast<QCPColorScale*>(element))
+      {
+        signature << colorScale->type() << colorScale->barWidth();
+        axes << colorScale->axis();
+      }
+    }
+    for (int k=0; k<axes.size(); ++k)
+    {
+      if (QCPAxis *axis = axes.at(k))
+        signature << axis->calculateMargin() << axis->offset();
+    }
   }
+  return signature;
 }
 
 /*! \internal
 
   This method is used by \ref setupPaintBuffers when it needs to create new paint buffers.
 
-  Depending on the current setting of \ref setOpenGl, and the current Qt version, different
-  backends (subclasses of \ref QCPAbstractPaintBuffer) are created, initialized with the proper
+  Depending on the current setting of \ref setOpenGl, \ref setPaintBufferType, \ref
+  setBackgroundRendering and the current Qt version, different backends (subclasses of \ref QCPAbstractPaintBuffer) are created, initialized with the proper
   size and device pixel ratio, and returned.
 */
 QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
@@ -15145,10 +17051,33 @@ QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
     qDebug() << Q_FUNC_INFO << "OpenGL enabled even though no support for it compiled in, this shouldn't have happened. Falling back to pixmap paint buffer.";
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 #endif
-  } else
+  } else if (usesImagePaintBuffers())
+    return new QCPPaintBufferImage(viewport().size(), mBufferDevicePixelRatio);
+  else
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 }
 
+/*! \internal
+  
+  Returns a paint buffer for \ref setupPaintBuffers. Buffers that became unneeded in an earlier
+  call of \ref setupPaintBuffers are kept in a pool and reused here, adapted to the current
+  viewport size and device pixel ratio. Only if the pool is empty, a new buffer is created with \ref
+  createPaintBuffer.
+*/
+QSharedPointer<QCPAbstractPaintBuffer> QCustomPlot::takePaintBuffer()
+{
+  // pooled buffers may still be referenced by a background render task, which would overwrite their content when finished:
+  if (!mPaintBufferPool.isEmpty() && mRunningRenderTask.isNull() && mPendingRenderTask.isNull())
+  {
+    QSharedPointer<QCPAbstractPaintBuffer> buffer = mPaintBufferPool.takeLast();
+    buffer->setDevicePixelRatio(mBufferDevicePixelRatio);
+    buffer->setSize(viewport().size());
+    buffer->setInvalidated();
+    return buffer;
+  }
+  return QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer());
+}
+
 /*!
   This method returns whether any of the paint buffers held by this QCustomPlot instance are
   invalidated.
@@ -15170,6 +17099,233 @@ bool QCustomPlot::hasInvalidatedPaintBuffers()
   return false;
 }
 
+/*! \internal
+  
+  Returns whether layers are currently rasterized on a worker thread, i.e. whether \ref
+  setBackgroundRendering is enabled and OpenGL isn't used.
+*/
+bool QCustomPlot::renderingInBackground() const
+{
+  return mBackgroundRendering && !mOpenGl;
+}
+
+/*! \internal
+  
+  Returns whether \ref createPaintBuffer creates \ref QCPPaintBufferImage instances, see \ref
+  setPaintBufferType and \ref setBackgroundRendering.
+*/
+bool QCustomPlot::usesImagePaintBuffers() const
+{
+  return !mOpenGl && (mPaintBufferType == pbtImage || mBackgroundRendering);
+}
+
+/*! \internal
+  
+  Records the content of all layers associated with \a buffer into QPicture instances, so they can
+  be rasterized in another thread (see \ref QCPPaintBufferRenderTask). The pictures are appended
+  to \a pictures, and the rects of the buffer they cover to \a rects. They must be composited in
+  this order.
+  
+  Usually, this is a single picture covering the whole buffer. If the plotting hint \ref
+  QCP::phParallelAxisRects is set and the axis rects don't overlap, the layerables that are clipped
+  to an axis rect (e.g. plottables) are recorded into a separate picture per axis rect, covering
+  only that axis rect. To preserve the drawing order, the layerables of the buffer are split into
+  consecutive phases of clipped and unclipped layerables. Within a phase of clipped layerables, the
+  order of the axis rects is irrelevant since they don't overlap.
+  
+  Label caching is disabled for the recording, because the cached pixmaps may not be used outside
+  the GUI thread.
+*/
+void QCustomPlot::recordPaintBuffer(const QSharedPointer<QCPAbstractPaintBuffer> &buffer, QList<QPicture> *pictures, QList<QRect> *rects)
+{
+  const QRect fullRect(QPoint(0, 0), buffer->size());
+  QList<QRect> tileRects;
+  if (mPlottingHints.testFlag(QCP::phParallelAxisRects))
+  {
+    const QList<QCPAxisRect*> axisRectList = axisRects();
+    for (int i=0; i<axisRectList.size(); ++i)
+      tileRects.append(axisRectList.at(i)->rect().adjusted(0, -1, 0, 0) & fullRect); // layerables are clipped to their clip rect translated by -1 in y, see QCPLayer::draw
+    bool disjoint = true;
+    for (int i=0; i<tileRects.size() && disjoint; ++i)
+    {
+      for (int k=i+1; k<tileRects.size() && disjoint; ++k)
+        disjoint = !tileRects.at(i).intersects(tileRects.at(k));
+    }
+    if (!disjoint)
+      tileRects.clear();
+  }
+  
+  QList<QCPLayerable*> phaseLayerables;
+  QList<int> phaseTiles; // tile index for each layerable of the phase, -1 if it isn't clipped to a tile
+  foreach (QCPLayer *layer, mLayers)
+  {
+    if (layer->mPaintBuffer.data() != buffer.data())
+      continue;
+    foreach (QCPLayerable *child, layer->children())
+    {
+      if (!child->realVisibility())
+        continue;
+      int tile = -1;
+      const QRect clip = child->clipRect().translated(0, -1);
+      for (int i=0; i<tileRects.size() && tile < 0; ++i)
+      {
+        if (tileRects.at(i).contains(clip))
+          tile = i;
+      }
+      // a change between clipped and unclipped layerables starts a new phase:
+      if (!phaseTiles.isEmpty() && (phaseTiles.last() < 0) != (tile < 0))
+      {
+        recordPhase(phaseLayerables, phaseTiles, tileRects, fullRect, pictures, rects);
+        phaseLayerables.clear();
+        phaseTiles.clear();
+      }
+      phaseLayerables.append(child);
+      phaseTiles.append(tile);
+    }
+  }
+  if (!phaseLayerables.isEmpty() || pictures->isEmpty())
+    recordPhase(phaseLayerables, phaseTiles, tileRects, fullRect, pictures, rects);
+}
+
+/*! \internal
+  
+  Records one phase of \ref recordPaintBuffer. If the \a layerables are clipped to tiles (as given
+  by \a tiles, indices into \a tileRects), one picture per tile is recorded. Otherwise a single
+  picture covering \a fullRect is recorded.
+*/
+void QCustomPlot::recordPhase(const QList<QCPLayerable*> &layerables, const QList<int> &tiles, const QList<QRect> &tileRects, const QRect &fullRect, QList<QPicture> *pictures, QList<QRect> *rects)
+{
+  if (!tiles.isEmpty() && tiles.first() >= 0)
+  {
+    QList<int> recordedTiles;
+    for (int i=0; i<tiles.size(); ++i)
+    {
+      if (recordedTiles.contains(tiles.at(i)))
+        continue;
+      recordedTiles.append(tiles.at(i));
+      QList<QCPLayerable*> tileLayerables;
+      for (int k=i; k<tiles.size(); ++k)
+      {
+        if (tiles.at(k) == tiles.at(i))
+          tileLayerables.append(layerables.at(k));
+      }
+      pictures->append(recordLayerables(tileLayerables));
+      rects->append(tileRects.at(tiles.at(i)));
+    }
+  } else
+  {
+    pictures->append(recordLayerables(layerables));
+    rects->append(fullRect);
+  }
+}
+
+/*! \internal
+  
+  Draws \a layerables into a QPicture the same way \ref QCPLayer::draw does (see \ref
+  QCPLayer::drawLayerable), and returns it.
+*/
+QPicture QCustomPlot::recordLayerables(const QList<QCPLayerable*> &layerables)
+{
+  QPicture picture;
+  QCPPainter painter(&picture);
+  painter.setRenderHint(QPainter::HighQualityAntialiasing);
+  painter.setMode(QCPPainter::pmNoCaching);
+  for (int i=0; i<layerables.size(); ++i)
+    QCPLayer::drawLayerable(&painter, layerables.at(i));
+  painter.end();
+  return picture;
+}
+
+/*! \internal
+  
+  Records the content of \a buffer (see \ref recordPaintBuffer) and adds it to the pending
+  background render task, replacing an older recording of the same buffer. The task is started
+  with \ref startBackgroundRendering.
+*/
+void QCustomPlot::queueBackgroundRendering(const QSharedPointer<QCPAbstractPaintBuffer> &buffer)
+{
+  if (mPendingRenderTask.isNull())
+    mPendingRenderTask = QSharedPointer<QCPPaintBufferRenderTask>(new QCPPaintBufferRenderTask(this, "backgroundRenderingFinished"));
+  QList<QPicture> pictures;
+  QList<QRect> rects;
+  recordPaintBuffer(buffer, &pictures, &rects);
+  mPendingRenderTask->removePictures(buffer);
+  for (int i=0; i<pictures.size(); ++i)
+    mPendingRenderTask->addPicture(buffer, pictures.at(i), rects.at(i));
+}
+
+/*! \internal
+  
+  Starts the pending background render task on the render thread pool, unless a task is still
+  running. In that case, the pending task is started once the running one has finished (see \ref
+  backgroundRenderingFinished), so all recordings in between are merged into one task.
+*/
+void QCustomPlot::startBackgroundRendering()
+{
+  if (mRunningRenderTask.isNull() && !mPendingRenderTask.isNull())
+  {
+    mRunningRenderTask = mPendingRenderTask;
+    mPendingRenderTask.clear();
+    mRunningRenderDamage = mPendingRenderDamage;
+    mPendingRenderDamage = QRegion();
+    mRenderThreadPool->start(mRunningRenderTask.data());
+  }
+}
+
+/*! \internal
+  
+  Called in the GUI thread when the running background render task has finished. Hands the
+  rendered images to the paint buffers, starts the pending task if there is one, and repaints the
+  region of the widget that was damaged by the finished task.
+*/
+void QCustomPlot::backgroundRenderingFinished()
+{
+  const QRegion damage = mRunningRenderDamage;
+  mRunningRenderDamage = QRegion();
+  if (!mRunningRenderTask.isNull())
+  {
+    mRunningRenderTask->applyImages();
+    mRunningRenderTask.clear();
+  }
+  startBackgroundRendering();
+  update(damage);
+}
+
+/*! \internal
+  
+  Redraws the paint buffers \a buffers concurrently, if the plotting hint \ref
+  QCP::phParallelLayers or \ref QCP::phParallelAxisRects is set.
+  
+  The layerables themselves are drawn (recorded, see \ref recordPaintBuffer) serially on the GUI
+  thread, because layerables may share state, e.g. axes or data columns with their search caches.
+  Only the rasterization of the recorded pictures is distributed over the render thread pool, with
+  one painter per picture. The GUI thread rasterizes the first picture itself and then waits for
+  the others. Finally, the images are handed to the buffers in layer order.
+*/
+void QCustomPlot::renderInParallel(const QList<QSharedPointer<QCPAbstractPaintBuffer> > &buffers)
+{
+  QList<QSharedPointer<QCPPaintBufferRenderTask> > tasks;
+  for (int i=0; i<buffers.size(); ++i)
+  {
+    QList<QPicture> pictures;
+    QList<QRect> rects;
+    recordPaintBuffer(buffers.at(i), &pictures, &rects);
+    for (int k=0; k<pictures.size(); ++k)
+    {
+      QSharedPointer<QCPPaintBufferRenderTask> task(new QCPPaintBufferRenderTask);
+      task->addPicture(buffers.at(i), pictures.at(k), rects.at(k));
+      tasks.append(task);
+    }
+  }
+  if (tasks.isEmpty())
+    return;
+  for (int i=1; i<tasks.size(); ++i)
+    mRenderThreadPool->start(tasks.at(i).data());
+  tasks.first()->run();
+  mRenderThreadPool->waitForDone();
+  QCPPaintBufferRenderTask::applyImages(tasks);
+}
+
 /*! \internal
 
   When \ref setOpenGl is set to true, this method is used to initialize OpenGL (create a context,
@@ -15635,7 +17791,7 @@ QList<QCPLayerable*> QCustomPlot::layerableListAt(const QPointF &pos, bool onlyS
 */
 bool QCustomPlot::saveRastered(const QString &fileName, int width, int height, double scale, const char *format, int quality, int resolution, QCP::ResolutionUnit resolutionUnit)
 {
-  QImage buffer = toPixmap(width, height, scale).toImage();
+  QImage buffer = toImage(width, height, scale);
   
   int dotsPerMeter = 0;
   switch (resolutionUnit)
@@ -15691,15 +17847,99 @@ QPixmap QCustomPlot::toPixmap(int width, int height, double scale)
         painter.setMode(QCPPainter::pmNonCosmetic);
       painter.scale(scale, scale);
     }
-    if (mBackgroundBrush.style() != Qt::SolidPattern && mBackgroundBrush.style() != Qt::NoBrush) // solid fills were done a few lines above with QPixmap::fill
+    if (mBackgroundBrush.style() != Qt::SolidPattern && mBackgroundBrush.style() != Qt::NoBrush) // solid fills were done a few lines above with QPixmap::fill
+      painter.fillRect(mViewport, mBackgroundBrush);
+    draw(&painter);
+    setViewport(oldViewport);
+    painter.end();
+  } else // might happen if pixmap has width or height zero
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't activate painter on pixmap";
+    return QPixmap();
+  }
+  return result;
+}
+
+/*!
+  Renders the plot to an image and returns it. Unlike \ref toPixmap, the plot is drawn directly
+  into a QImage, so no conversion from a pixmap is necessary. Like all other methods of
+  QCustomPlot, this method must be called in the GUI thread, because drawing the plot updates the
+  layout and the axes.
+  
+  The plot is sized to \a width and \a height in pixels and scaled with \a scale. (width 100 and
+  scale 2.0 lead to a full resolution image with width 200.)
+  
+  The image is composited from the paint buffers without drawing the plot again, if all of the
+  following applies: The plot is requested at the size of the widget without scaling, the paint
+  buffers are based on QImage (see \ref setPaintBufferType), and the buffers are known to be up to
+  date. The latter requires the plotting hints \ref QCP::phSkipCleanLayers and \ref
+  QCP::phSkipUnchangedLayout, so that no layer was marked dirty (see \ref QCPLayer::markDirty),
+  and neither the axis ranges nor anything else that affects the layout changed since the last
+  \ref replot. Otherwise, the plot is drawn as usual.
+  
+  \see toPainter, saveRastered, saveBmp, savePng, saveJpg, savePdf
+*/
+QImage QCustomPlot::toImage(int width, int height, double scale)
+{
+  // this method is somewhat similar to toPixmap. Change something here, and a change in toPixmap might be necessary, too.
+  int newWidth, newHeight;
+  if (width == 0 || height == 0)
+  {
+    newWidth = this->width();
+    newHeight = this->height();
+  } else
+  {
+    newWidth = width;
+    newHeight = height;
+  }
+  int scaledWidth = qRound(scale*newWidth);
+  int scaledHeight = qRound(scale*newHeight);
+  
+  QImage result(scaledWidth, scaledHeight, QImage::Format_ARGB32_Premultiplied);
+  if (usesImagePaintBuffers() && mViewport == QRect(0, 0, newWidth, newHeight) && qFuzzyCompare(scale, 1.0) && qFuzzyCompare(mBufferDevicePixelRatio, 1.0) &&
+      mPlottingHints.testFlag(QCP::phSkipCleanLayers) && mPlottingHints.testFlag(QCP::phSkipUnchangedLayout) &&
+      !hasInvalidatedPaintBuffers() && mRunningRenderTask.isNull() && mPendingRenderTask.isNull())
+  {
+    bool upToDate = !mLayoutSignature.isEmpty() && frameSignature() == mFrameSignature && layoutSignature() == mLayoutSignature; // the buffers show the current axis ranges and layout
+    foreach (QCPLayer *layer, mLayers)
+      upToDate = upToDate && !layer->dirty();
+    if (upToDate) // reuse the rendered paint buffers, like the paint event does
+    {
+      result.fill(Qt::transparent);
+      QCPPainter painter(&result);
+      if (mBackgroundBrush.style() != Qt::NoBrush)
+        painter.fillRect(mViewport, mBackgroundBrush);
+      drawBackground(&painter);
+      for (int bufferIndex = 0; bufferIndex < mPaintBuffers.size(); ++bufferIndex)
+        mPaintBuffers.at(bufferIndex)->draw(&painter);
+      painter.end();
+      return result;
+    }
+  }
+  
+  result.fill(mBackgroundBrush.style() == Qt::SolidPattern ? mBackgroundBrush.color() : QColor(Qt::transparent)); // if using non-solid pattern, make transparent now and draw brush pattern later
+  QCPPainter painter;
+  painter.begin(&result);
+  if (painter.isActive())
+  {
+    QRect oldViewport = viewport();
+    setViewport(QRect(0, 0, newWidth, newHeight));
+    painter.setMode(QCPPainter::pmNoCaching);
+    if (!qFuzzyCompare(scale, 1.0))
+    {
+      if (scale > 1.0) // for scale < 1 we always want cosmetic pens where possible, because else lines might disappear for very small scales
+        painter.setMode(QCPPainter::pmNonCosmetic);
+      painter.scale(scale, scale);
+    }
+    if (mBackgroundBrush.style() != Qt::SolidPattern && mBackgroundBrush.style() != Qt::NoBrush) // solid fills were done a few lines above with QImage::fill
       painter.fillRect(mViewport, mBackgroundBrush);
     draw(&painter);
     setViewport(oldViewport);
     painter.end();
-  } else // might happen if pixmap has width or height zero
+  } else // might happen if image has width or height zero
   {
-    qDebug() << Q_FUNC_INFO << "Couldn't activate painter on pixmap";
-    return QPixmap();
+    qDebug() << Q_FUNC_INFO << "Couldn't activate painter on image";
+    return QImage();
   }
   return result;
 }
@@ -17326,6 +19566,7 @@ void QCPAxisRect::setBackground(const QPixmap &pm)
 {
   mBackgroundPixmap = pm;
   mScaledBackgroundPixmap = QPixmap();
+  markDirty();
 }
 
 /*! \overload
@@ -17344,6 +19585,7 @@ void QCPAxisRect::setBackground(const QPixmap &pm)
 void QCPAxisRect::setBackground(const QBrush &brush)
 {
   mBackgroundBrush = brush;
+  markDirty();
 }
 
 /*! \overload
@@ -17359,6 +19601,7 @@ void QCPAxisRect::setBackground(const QPixmap &pm, bool scaled, Qt::AspectRatioM
   mScaledBackgroundPixmap = QPixmap();
   mBackgroundScaled = scaled;
   mBackgroundScaledMode = mode;
+  markDirty();
 }
 
 /*!
@@ -17374,6 +19617,7 @@ void QCPAxisRect::setBackground(const QPixmap &pm, bool scaled, Qt::AspectRatioM
 void QCPAxisRect::setBackgroundScaled(bool scaled)
 {
   mBackgroundScaled = scaled;
+  markDirty();
 }
 
 /*!
@@ -17384,6 +19628,7 @@ void QCPAxisRect::setBackgroundScaled(bool scaled)
 void QCPAxisRect::setBackgroundScaledMode(Qt::AspectRatioMode mode)
 {
   mBackgroundScaledMode = mode;
+  markDirty();
 }
 
 /*!
@@ -18028,6 +20273,7 @@ QCPAbstractLegendItem::QCPAbstractLegendItem(QCPLegend *parent) :
 void QCPAbstractLegendItem::setFont(const QFont &font)
 {
   mFont = font;
+  markDirty();
 }
 
 /*!
@@ -18038,6 +20284,7 @@ void QCPAbstractLegendItem::setFont(const QFont &font)
 void QCPAbstractLegendItem::setTextColor(const QColor &color)
 {
   mTextColor = color;
+  markDirty();
 }
 
 /*!
@@ -18049,6 +20296,7 @@ void QCPAbstractLegendItem::setTextColor(const QColor &color)
 void QCPAbstractLegendItem::setSelectedFont(const QFont &font)
 {
   mSelectedFont = font;
+  markDirty();
 }
 
 /*!
@@ -18060,6 +20308,7 @@ void QCPAbstractLegendItem::setSelectedFont(const QFont &font)
 void QCPAbstractLegendItem::setSelectedTextColor(const QColor &color)
 {
   mSelectedTextColor = color;
+  markDirty();
 }
 
 /*!
@@ -18089,6 +20338,7 @@ void QCPAbstractLegendItem::setSelected(bool selected)
   if (mSelected != selected)
   {
     mSelected = selected;
+    markDirty();
     emit selectionChanged(mSelected);
   }
 }
@@ -18385,6 +20635,7 @@ QCPLegend::SelectableParts QCPLegend::selectedParts() const
 void QCPLegend::setBorderPen(const QPen &pen)
 {
   mBorderPen = pen;
+  markDirty();
 }
 
 /*!
@@ -18393,6 +20644,7 @@ void QCPLegend::setBorderPen(const QPen &pen)
 void QCPLegend::setBrush(const QBrush &brush)
 {
   mBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -18412,6 +20664,7 @@ void QCPLegend::setFont(const QFont &font)
     if (item(i))
       item(i)->setFont(mFont);
   }
+  markDirty();
 }
 
 /*!
@@ -18431,6 +20684,7 @@ void QCPLegend::setTextColor(const QColor &color)
     if (item(i))
       item(i)->setTextColor(color);
   }
+  markDirty();
 }
 
 /*!
@@ -18440,6 +20694,7 @@ void QCPLegend::setTextColor(const QColor &color)
 void QCPLegend::setIconSize(const QSize &size)
 {
   mIconSize = size;
+  markDirty();
 }
 
 /*! \overload
@@ -18448,6 +20703,7 @@ void QCPLegend::setIconSize(int width, int height)
 {
   mIconSize.setWidth(width);
   mIconSize.setHeight(height);
+  markDirty();
 }
 
 /*!
@@ -18458,6 +20714,7 @@ void QCPLegend::setIconSize(int width, int height)
 void QCPLegend::setIconTextPadding(int padding)
 {
   mIconTextPadding = padding;
+  markDirty();
 }
 
 /*!
@@ -18469,6 +20726,7 @@ void QCPLegend::setIconTextPadding(int padding)
 void QCPLegend::setIconBorderPen(const QPen &pen)
 {
   mIconBorderPen = pen;
+  markDirty();
 }
 
 /*!
@@ -18534,6 +20792,7 @@ void QCPLegend::setSelectedParts(const SelectableParts &selected)
     mSelectedParts = newSelected;
     emit selectionChanged(mSelectedParts);
   }
+  markDirty();
 }
 
 /*!
@@ -18545,6 +20804,7 @@ void QCPLegend::setSelectedParts(const SelectableParts &selected)
 void QCPLegend::setSelectedBorderPen(const QPen &pen)
 {
   mSelectedBorderPen = pen;
+  markDirty();
 }
 
 /*!
@@ -18555,6 +20815,7 @@ void QCPLegend::setSelectedBorderPen(const QPen &pen)
 void QCPLegend::setSelectedIconBorderPen(const QPen &pen)
 {
   mSelectedIconBorderPen = pen;
+  markDirty();
 }
 
 /*!
@@ -18566,6 +20827,7 @@ void QCPLegend::setSelectedIconBorderPen(const QPen &pen)
 void QCPLegend::setSelectedBrush(const QBrush &brush)
 {
   mSelectedBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -18583,6 +20845,7 @@ void QCPLegend::setSelectedFont(const QFont &font)
     if (item(i))
       item(i)->setSelectedFont(font);
   }
+  markDirty();
 }
 
 /*!
@@ -18600,6 +20863,7 @@ void QCPLegend::setSelectedTextColor(const QColor &color)
     if (item(i))
       item(i)->setSelectedTextColor(color);
   }
+  markDirty();
 }
 
 /*!
@@ -19044,6 +21308,7 @@ QCPTextElement::QCPTextElement(QCustomPlot *parentPlot, const QString &text, con
 void QCPTextElement::setText(const QString &text)
 {
   mText = text;
+  markDirty();
 }
 
 /*!
@@ -19069,6 +21334,7 @@ void QCPTextElement::setText(const QString &text)
 void QCPTextElement::setTextFlags(int flags)
 {
   mTextFlags = flags;
+  markDirty();
 }
 
 /*!
@@ -19079,6 +21345,7 @@ void QCPTextElement::setTextFlags(int flags)
 void QCPTextElement::setFont(const QFont &font)
 {
   mFont = font;
+  markDirty();
 }
 
 /*!
@@ -19089,6 +21356,7 @@ void QCPTextElement::setFont(const QFont &font)
 void QCPTextElement::setTextColor(const QColor &color)
 {
   mTextColor = color;
+  markDirty();
 }
 
 /*!
@@ -19099,6 +21367,7 @@ void QCPTextElement::setTextColor(const QColor &color)
 void QCPTextElement::setSelectedFont(const QFont &font)
 {
   mSelectedFont = font;
+  markDirty();
 }
 
 /*!
@@ -19109,6 +21378,7 @@ void QCPTextElement::setSelectedFont(const QFont &font)
 void QCPTextElement::setSelectedTextColor(const QColor &color)
 {
   mSelectedTextColor = color;
+  markDirty();
 }
 
 /*!
@@ -19138,6 +21408,7 @@ void QCPTextElement::setSelected(bool selected)
   if (mSelected != selected)
   {
     mSelected = selected;
+    markDirty();
     emit selectionChanged(mSelected);
   }
 }
@@ -19478,6 +21749,7 @@ void QCPColorScale::setType(QCPAxis::AxisType type)
     connect(mColorAxis.data(), SIGNAL(scaleTypeChanged(QCPAxis::ScaleType)), this, SLOT(setDataScaleType(QCPAxis::ScaleType)));
     mAxisRect.data()->setRangeDragAxes(QList<QCPAxis*>() << mColorAxis.data());
   }
+  markDirty();
 }
 
 /*!
@@ -19498,6 +21770,7 @@ void QCPColorScale::setDataRange(const QCPRange &dataRange)
       mColorAxis.data()->setRange(mDataRange);
     emit dataRangeChanged(mDataRange);
   }
+  markDirty();
 }
 
 /*!
@@ -19530,6 +21803,7 @@ void QCPColorScale::setDataScaleType(QCPAxis::ScaleType scaleType)
       setDataRange(mDataRange.sanitizedForLogScale());
     emit dataScaleTypeChanged(mDataScaleType);
   }
+  markDirty();
 }
 
 /*!
@@ -19548,6 +21822,7 @@ void QCPColorScale::setGradient(const QCPColorGradient &gradient)
       mAxisRect.data()->mGradientImageInvalidated = true;
     emit gradientChanged(mGradient);
   }
+  markDirty();
 }
 
 /*!
@@ -19563,6 +21838,7 @@ void QCPColorScale::setLabel(const QString &str)
   }
   
   mColorAxis.data()->setLabel(str);
+  markDirty();
 }
 
 /*!
@@ -19572,6 +21848,7 @@ void QCPColorScale::setLabel(const QString &str)
 void QCPColorScale::setBarWidth(int width)
 {
   mBarWidth = width;
+  markDirty();
 }
 
 /*!
@@ -19981,66 +22258,571 @@ void QCPColorScaleAxisRectPrivate::axisSelectableChanged(QCPAxis::SelectablePart
   see the documentation of \ref QCPDataContainer.
 */
 
-/*! \fn static QCPGraphData QCPGraphData::fromSortKey(double sortKey)
-  
-  Returns a data point with the specified \a sortKey. All other members are set to zero.
+/*! \fn static QCPGraphData QCPGraphData::fromSortKey(double sortKey)
+  
+  Returns a data point with the specified \a sortKey. All other members are set to zero.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn static static bool QCPGraphData::sortKeyIsMainKey()
+  
+  Since the member \a key is both the data point key coordinate and the data ordering parameter,
+  this method returns true.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn double QCPGraphData::mainKey() const
+  
+  Returns the \a key member of this data point.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn double QCPGraphData::mainValue() const
+  
+  Returns the \a value member of this data point.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn QCPRange QCPGraphData::valueRange() const
+  
+  Returns a QCPRange with both lower and upper boundary set to \a value of this data point.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs a data point with key and value set to zero.
+*/
+QCPGraphData::QCPGraphData() :
+  key(0),
+  value(0)
+{
+}
+
+/*!
+  Constructs a data point with the specified \a key and \a value.
+*/
+QCPGraphData::QCPGraphData(double key, double value) :
+  key(key),
+  value(value)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPGraphColumnData
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPGraphColumnData
+  \brief Holds the data of a QCPGraph as separate key and value columns
+  
+  This is the structure-of-arrays counterpart of \ref QCPGraphDataContainer. Instead of storing
+  interleaved \ref QCPGraphData points, the keys and the values are held in two \ref QCPDataColumn
+  instances. The data point at index \a i consists of the key at index \a i of the key column and
+  the value at index \a i of the value column. If the two columns have different sizes, the
+  number of data points is the size of the smaller column.
+  
+  The key column must be sorted in ascending order. Unlike \ref QCPDataContainer, this class
+  doesn't sort the data itself.
+  
+  To display column data with a graph, pass it to \ref QCPGraph::setColumnData, or pass the two
+  columns to \ref QCPGraph::setData(QSharedPointer<QCPDataColumn>, QSharedPointer<QCPDataColumn>).
+  The graph then accesses the data via its \ref QCPPlottableInterface1D "1D interface", so data
+  selection, tracers and similar features work the same as with the regular data container.
+  
+  Since the columns are held via QSharedPointer, several column data instances may share a column,
+  for example multiple graphs with the same keys but different values.
+  
+  \section qcpgraphcolumndata-mappedfile Memory-mapped files
+  
+  Data sets that are too large to be loaded into memory can be displayed directly from a binary
+  file with \ref fromMappedFile. The file is mapped into the address space of the process and the
+  columns read the samples from the mapping, so opening the file takes constant time and only the
+  pages that are actually accessed are read from disk. The file must have the following layout,
+  with all numbers in the native byte order of the machine:
+  
+  <table>
+  <tr><th>Offset (bytes)</th><th>Size (bytes)</th><th>Content</th></tr>
+  <tr><td>0</td><td>8</td><td>The magic characters <tt>QCPGRAPH</tt> (without terminating null)</td></tr>
+  <tr><td>8</td><td>8</td><td>The number of data points \a N as unsigned 64 bit integer</td></tr>
+  <tr><td>16</td><td>8*\a N</td><td>The keys as doubles, sorted in ascending order</td></tr>
+  <tr><td>16+8*\a N</td><td>8*\a N</td><td>The values as doubles, in the order of their keys</td></tr>
+  </table>
+  
+  When a graph displays such data, finding the visible data range binary-searches the mapped key
+  array, and drawing with adaptive sampling only touches the keys and values of the visible range.
+  Operations that inspect the entire data set, like \ref QCPAbstractPlottable::rescaleValueAxis,
+  read the whole value array and thus the whole file.
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn QSharedPointer<QCPDataColumn> QCPGraphColumnData::keys() const
+  
+  Returns the column holding the keys.
+*/
+
+/*! \fn QSharedPointer<QCPDataColumn> QCPGraphColumnData::values() const
+  
+  Returns the column holding the values.
+*/
+
+/*! \fn bool QCPGraphColumnData::isEmpty() const
+  
+  Returns whether there are no data points, i.e. whether \ref size is zero.
+*/
+
+/*! \fn double QCPGraphColumnData::key(int index) const
+  
+  Returns the key of the data point at \a index. The index must be valid, i.e. in the range 0 to
+  \ref size - 1.
+*/
+
+/*! \fn double QCPGraphColumnData::value(int index) const
+  
+  Returns the value of the data point at \a index. The index must be valid, i.e. in the range 0 to
+  \ref size - 1.
+*/
+
+/*! \fn QCPGraphData QCPGraphColumnData::at(int index) const
+  
+  Returns the data point at \a index. The index must be valid, i.e. in the range 0 to \ref size -
+  1.
+*/
+
+/*! \fn bool QCPGraphColumnData::hasConstantTimeSearch() const
+  
+  Returns whether the key column locates keys in constant time, see \ref
+  QCPDataColumn::hasConstantTimeSearch.
+*/
+
+/*! \fn int QCPGraphColumnData::lowerBound(double sortKey, int begin, int end) const
+  
+  Returns the index of the first data point in the index range \a begin to \a end (exclusive)
+  whose key is not smaller than \a sortKey, or \a end if there is no such data point.
+  
+  \see QCPDataColumn::lowerBound
+*/
+
+/*! \fn QCPDataRange QCPGraphColumnData::dataRange() const
+  
+  Returns a \ref QCPDataRange encompassing the entire data set.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs an empty column data instance without key and value columns.
+*/
+QCPGraphColumnData::QCPGraphColumnData()
+{
+}
+
+/*!
+  Constructs a column data instance that uses the column \a keys for the keys and the column \a
+  values for the values of its data points.
+*/
+QCPGraphColumnData::QCPGraphColumnData(QSharedPointer<QCPDataColumn> keys, QSharedPointer<QCPDataColumn> values) :
+  mKeys(keys),
+  mValues(values)
+{
+}
+
+/*!
+  Creates a column data instance that displays the data of the binary file \a fileName without
+  loading it into memory. The file is memory-mapped read-only and must have the layout described
+  in the \ref qcpgraphcolumndata-mappedfile "class documentation". Both returned columns are \ref
+  QCPBufferColumn "buffer columns" that refer to the mapping and keep the file mapped until they
+  are destroyed.
+  
+  The file must not be modified or truncated while it is mapped. Since data point indices are of
+  type int, the file may contain at most 2^31-1 data points. Note that mapping files larger than a
+  few gigabytes requires a 64 bit process.
+  
+  If the file can't be opened or mapped, or doesn't have the expected layout, returns a null
+  pointer.
+*/
+QSharedPointer<QCPGraphColumnData> QCPGraphColumnData::fromMappedFile(const QString &fileName)
+{
+  const char magic[8] = {'Q', 'C', 'P', 'G', 'R', 'A', 'P', 'H'};
+  const qint64 headerSize = sizeof(magic)+sizeof(quint64);
+  QSharedPointer<QFile> file(new QFile(fileName));
+  if (!file->open(QIODevice::ReadOnly))
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't open file" << fileName << file->errorString();
+    return QSharedPointer<QCPGraphColumnData>();
+  }
+  const qint64 fileSize = file->size();
+  if (fileSize < headerSize)
+  {
+    qDebug() << Q_FUNC_INFO << "File too small for header" << fileName;
+    return QSharedPointer<QCPGraphColumnData>();
+  }
+  const uchar *mapping = file->map(0, fileSize);
+  if (!mapping)
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't map file" << fileName << file->errorString();
+    return QSharedPointer<QCPGraphColumnData>();
+  }
+  
+  quint64 count;
+  memcpy(&count, mapping+sizeof(magic), sizeof(count));
+  if (memcmp(mapping, magic, sizeof(magic)) != 0)
+  {
+    qDebug() << Q_FUNC_INFO << "Invalid header in file" << fileName;
+    return QSharedPointer<QCPGraphColumnData>();
+  }
+  if (count > quint64((std::numeric_limits<int>::max)()) || headerSize+2*sizeof(double)*count > quint64(fileSize))
+  {
+    qDebug() << Q_FUNC_INFO << "Invalid data point count" << count << "for size of file" << fileName;
+    return QSharedPointer<QCPGraphColumnData>();
+  }
+  
+  // the header size is a multiple of 8 and mappings are page aligned, so the arrays are aligned for doubles:
+  const double *keys = reinterpret_cast<const double*>(mapping+headerSize);
+  const double *values = keys+count;
+  return QSharedPointer<QCPGraphColumnData>(new QCPGraphColumnData(QSharedPointer<QCPDataColumn>(new QCPBufferColumn(keys, int(count), file)),
+                                                                   QSharedPointer<QCPDataColumn>(new QCPBufferColumn(values, int(count), file))));
+}
+
+/*!
+  Returns the number of data points, which is the size of the smaller of the two columns. If
+  either column isn't set, returns 0.
+*/
+int QCPGraphColumnData::size() const
+{
+  if (!mKeys || !mValues)
+    return 0;
+  return qMin(mKeys->size(), mValues->size());
+}
+
+/*!
+  Sets the column holding the keys. The keys must be sorted in ascending order.
+  
+  \see setValues
+*/
+void QCPGraphColumnData::setKeys(QSharedPointer<QCPDataColumn> keys)
+{
+  mKeys = keys;
+}
+
+/*!
+  Sets the column holding the values.
+  
+  \see setKeys
+*/
+void QCPGraphColumnData::setValues(QSharedPointer<QCPDataColumn> values)
+{
+  mValues = values;
+}
+
+/*!
+  Returns the index of the data point with a key that is equal to, just below, or just above \a
+  sortKey. If \a expandedRange is true, the data point just below \a sortKey will be considered,
+  otherwise the one just above.
+  
+  This behaves like \ref QCPDataContainer::findBegin, but returns an index instead of an iterator.
+  If \a cacheSerial is not zero, the search in the key column is memoized as described for \ref
+  QCPDataColumn::cachedLowerBound.
+  
+  \see findEnd
+*/
+int QCPGraphColumnData::findBegin(double sortKey, bool expandedRange, uint cacheSerial) const
+{
+  const int count = size();
+  if (count == 0)
+    return 0;
+  
+  int index = count == mKeys->size() ? mKeys->cachedLowerBound(sortKey, cacheSerial) : mKeys->lowerBound(sortKey, 0, count);
+  if (expandedRange && index > 0) // also covers index == count case
+    --index;
+  return index;
+}
+
+/*!
+  Returns the index one after the data point with a key that is equal to, just above, or just
+  below \a sortKey. If \a expandedRange is true, the data point just above \a sortKey will be
+  considered, otherwise the one just below.
+  
+  This behaves like \ref QCPDataContainer::findEnd, but returns an index instead of an iterator.
+  If \a cacheSerial is not zero, the search in the key column is memoized as described for \ref
+  QCPDataColumn::cachedUpperBound.
+  
+  \see findBegin
+*/
+int QCPGraphColumnData::findEnd(double sortKey, bool expandedRange, uint cacheSerial) const
+{
+  const int count = size();
+  if (count == 0)
+    return 0;
+  
+  int index = count == mKeys->size() ? mKeys->cachedUpperBound(sortKey, cacheSerial) : mKeys->upperBound(sortKey, 0, count);
+  if (expandedRange && index < count)
+    ++index;
+  return index;
+}
+
+/*!
+  Returns the range encompassed by the keys of the data points whose value isn't NaN. This behaves
+  like \ref QCPDataContainer::keyRange.
+  
+  \see valueRange
+*/
+QCPRange QCPGraphColumnData::keyRange(bool &foundRange, QCP::SignDomain signDomain) const
+{
+  const int count = size();
+  QCPRange range;
+  bool haveLower = false;
+  bool haveUpper = false;
+  double current;
+  
+  if (signDomain == QCP::sdBoth) // keys are sorted, so just find the first and last key with non-NaN value
+  {
+    for (int i=0; i<count; ++i)
+    {
+      if (!qIsNaN(value(i)))
+      {
+        range.lower = key(i);
+        haveLower = true;
+        break;
+      }
+    }
+    for (int i=count-1; i>=0; --i)
+    {
+      if (!qIsNaN(value(i)))
+      {
+        range.upper = key(i);
+        haveUpper = true;
+        break;
+      }
+    }
+  } else
+  {
+    for (int i=0; i<count; ++i)
+    {
+      if (!qIsNaN(value(i)))
+      {
+        current = key(i);
+        if ((signDomain == QCP::sdNegative && current < 0) || (signDomain == QCP::sdPositive && current > 0))
+        {
+          if (current < range.lower || !haveLower)
+          {
+            range.lower = current;
+            haveLower = true;
+          }
+          if (current > range.upper || !haveUpper)
+          {
+            range.upper = current;
+            haveUpper = true;
+          }
+        }
+      }
+    }
+  }
+  
+  foundRange = haveLower && haveUpper;
+  return range;
+}
+
+/*!
+  Returns the range encompassed by the values of the data points. This behaves like \ref
+  QCPDataContainer::valueRange: NaN values are ignored, \a signDomain restricts the considered
+  values to the respective sign domain, and if \a inKeyRange isn't the default QCPRange, only data
+  points with keys inside \a inKeyRange are taken into account.
+  
+  \see keyRange
+*/
+QCPRange QCPGraphColumnData::valueRange(bool &foundRange, QCP::SignDomain signDomain, const QCPRange &inKeyRange) const
+{
+  int begin = 0;
+  int end = size();
+  if (inKeyRange != QCPRange())
+  {
+    begin = findBegin(inKeyRange.lower, false);
+    end = findEnd(inKeyRange.upper, false);
+  }
+  return valueRange(foundRange, begin, end, signDomain);
+}
+
+/*! \overload
+  
+  Returns the range encompassed by the values of the data points in the index range \a begin to \a
+  end (exclusive). NaN values are ignored, and \a signDomain restricts the considered values to
+  the respective sign domain.
+  
+  \see QCPDataColumn::range
+*/
+QCPRange QCPGraphColumnData::valueRange(bool &foundRange, int begin, int end, QCP::SignDomain signDomain) const
+{
+  if (!mValues)
+  {
+    foundRange = false;
+    return QCPRange();
+  }
+  return mValues->range(foundRange, begin, qMin(end, size()), signDomain);
+}
+
+/*!
+  Writes the data points in the index range \a begin to \a end (exclusive) to the array starting
+  at \a target, which must have room for at least \a end - \a begin data points.
+*/
+void QCPGraphColumnData::copy(int begin, int end, QCPGraphData *target) const
+{
+  const double *keyData = mKeys->constData();
+  const double *valueData = mValues->constData();
+  if (keyData && valueData)
+  {
+    for (int i=begin; i<end; ++i, ++target)
+    {
+      target->key = keyData[i];
+      target->value = valueData[i];
+    }
+  } else
+  {
+    for (int i=begin; i<end; ++i, ++target)
+    {
+      target->key = mKeys->at(i);
+      target->value = mValues->at(i);
+    }
+  }
+}
+
+/*! \internal
   
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
+  Provides index based access to a \ref QCPGraphDataContainer with the same interface as \ref
+  QCPGraphColumnData, so the sampling algorithms of QCPGraph (\ref QCPGraph::sampleLineData, \ref
+  QCPGraph::sampleScatterData) can be shared by both storage layouts.
 */
-
-/*! \fn static static bool QCPGraphData::sortKeyIsMainKey()
+class QCPGraphDataContainerSource
+{
+public:
+  explicit QCPGraphDataContainerSource(const QCPGraphDataContainer *container) : mContainer(container), mBegin(container->constBegin()) {}
   
-  Since the member \a key is both the data point key coordinate and the data ordering parameter,
-  this method returns true.
+  inline double key(int index) const { return (mBegin+index)->key; }
+  inline double value(int index) const { return (mBegin+index)->value; }
+  inline QCPGraphData at(int index) const { return *(mBegin+index); }
+  bool hasConstantTimeSearch() const { return false; }
+  int lowerBound(double sortKey, int begin, int end) const
+  {
+    return std::lower_bound(mBegin+begin, mBegin+end, QCPGraphData::fromSortKey(sortKey), qcpLessThanSortKey<QCPGraphData>)-mBegin;
+  }
+  QCPRange valueRange(bool &foundRange, int begin, int end) const { return mContainer->valueRange(foundRange, mBegin+begin, mBegin+end); }
+  void copy(int begin, int end, QCPGraphData *target) const { std::copy(mBegin+begin, mBegin+end, target); }
+  void prepareConcurrentReads(int begin, int end) const
+  {
+    if (mContainer->valueRangeIndex()) // build the lazily updated value range index now, so the sampling threads only read it
+    {
+      bool foundRange;
+      mContainer->valueRange(foundRange, mBegin+begin, mBegin+end);
+    }
+  }
   
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
-*/
+private:
+  const QCPGraphDataContainer *mContainer;
+  QCPGraphDataContainer::const_iterator mBegin;
+};
 
-/*! \fn double QCPGraphData::mainKey() const
-  
-  Returns the \a key member of this data point.
+/*! \internal
   
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
+  Prepares the data \a source for concurrent reads by multiple sampling threads, see \ref
+  QCPGraphSamplingTask. Data columns don't have lazily updated state, so nothing needs to be done.
 */
+static inline void qcpPrepareConcurrentReads(const QCPGraphColumnData &source, int begin, int end)
+{
+  Q_UNUSED(source)
+  Q_UNUSED(begin)
+  Q_UNUSED(end)
+}
 
-/*! \fn double QCPGraphData::mainValue() const
-  
-  Returns the \a value member of this data point.
+/*! \internal
   
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
+  \overload
 */
+static inline void qcpPrepareConcurrentReads(const QCPGraphDataContainerSource &source, int begin, int end)
+{
+  source.prepareConcurrentReads(begin, end);
+}
 
-/*! \fn QCPRange QCPGraphData::valueRange() const
-  
-  Returns a QCPRange with both lower and upper boundary set to \a value of this data point.
+/*! \internal
   
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
-*/
-
-/* end documentation of inline functions */
-
-/*!
-  Constructs a data point with key and value set to zero.
+  Holds the result of sampling one chunk of the data in \ref QCPGraph::sampleLineIntervalsInParallel.
 */
-QCPGraphData::QCPGraphData() :
-  key(0),
-  value(0)
+struct QCPGraphSamplingChunk
 {
-}
+  int begin, end;                        ///< data index range in which the pixel intervals of this chunk begin
+  QVector<QCPGraphData> lineData;        ///< the sampled points of all intervals of this chunk
+  QVector<QPair<int, int> > intervals;   ///< begin index of each interval and the size of \a lineData before it was appended
+  int next;                              ///< data index at which the interval following this chunk begins
+};
 
-/*!
-  Constructs a data point with the specified \a key and \a value.
+/*! \internal
+  
+  Samples the chunks of a \ref QCPGraph::sampleLineIntervalsInParallel call on the render thread
+  pool of QCustomPlot. All tasks of a call share a counter from which they take the next chunk to
+  process, so no task waits for another one, and the chunks are done even if the pool has no free
+  threads (the calling thread processes the chunks, too). When \ref run has finished, \a finished
+  is released once.
+  
+  The task doesn't delete itself after running (see QRunnable::setAutoDelete), the caller owns it.
 */
-QCPGraphData::QCPGraphData(double key, double value) :
-  key(key),
-  value(value)
+template <class DataSource>
+class QCPGraphSamplingTask : public QRunnable
 {
-}
+public:
+  QCPGraphSamplingTask(const QCPGraph *graph, const DataSource *source, int begin, int end, double keyEpsilon, QCPGraphSamplingChunk *chunks, int chunkCount, QAtomicInt *nextChunk, QSemaphore *finished) :
+    mGraph(graph),
+    mSource(source),
+    mBegin(begin),
+    mEnd(end),
+    mKeyEpsilon(keyEpsilon),
+    mChunks(chunks),
+    mChunkCount(chunkCount),
+    mNextChunk(nextChunk),
+    mFinished(finished)
+  {
+    setAutoDelete(false);
+  }
+  
+  /*!
+    Samples chunks until all chunks were taken by this or other tasks.
+  */
+  void processChunks()
+  {
+    int chunkIndex;
+    while ((chunkIndex = mNextChunk->fetchAndAddOrdered(1)) < mChunkCount)
+    {
+      QCPGraphSamplingChunk &chunk = mChunks[chunkIndex];
+      chunk.next = mGraph->sampleLineIntervals(&chunk.lineData, *mSource, mBegin, mEnd, chunk.begin, chunk.end, mKeyEpsilon, &chunk.intervals);
+    }
+  }
+  
+  virtual void run() Q_DECL_OVERRIDE
+  {
+    processChunks();
+    mFinished->release();
+  }
+  
+private:
+  const QCPGraph *mGraph;
+  const DataSource *mSource;
+  int mBegin, mEnd;
+  double mKeyEpsilon;
+  QCPGraphSamplingChunk *mChunks;
+  int mChunkCount;
+  QAtomicInt *mNextChunk;
+  QSemaphore *mFinished;
+};
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -20067,6 +22849,20 @@ QCPGraphData::QCPGraphData(double key, double value) :
   (<tt>qQNaN()</tt> or <tt>std::numeric_limits<double>::quiet_NaN()</tt>) in between the two data points that shall be
   separated.
   
+  \section qcpgraph-columndata Column data
+  
+  Instead of the interleaved \ref QCPGraphDataContainer, a graph can also display data that is
+  stored as separate key and value columns (see \ref QCPDataColumn and \ref QCPGraphColumnData).
+  Column data is assigned with \ref setColumnData or \ref setData(QSharedPointer<QCPDataColumn>,
+  QSharedPointer<QCPDataColumn>), and is used instead of the data container until a data container
+  or key/value vectors are set again via \ref setData. While column data is set, \ref addData still
+  modifies the (then unused) data container.
+  
+  Selection, tracers and other features access column data via the \ref QCPPlottableInterface1D
+  "1D interface" of the graph, so they work the same for both storage layouts. Reimplementations of
+  \ref getOptimizedLineData and \ref getOptimizedScatterData only take effect for the data
+  container.
+  
   \section qcpgraph-appearance Changing the appearance
   
   The appearance of the graph is mainly determined by the line style, scatter style, brush and pen
@@ -20094,6 +22890,14 @@ QCPGraphData::QCPGraphData(double key, double value) :
   regular \ref setData or \ref addData methods.
 */
 
+/*! \fn QSharedPointer<QCPGraphColumnData> QCPGraph::columnData() const
+  
+  Returns a shared pointer to the column data of this graph, or a null pointer if the graph
+  displays the data of its data container (\ref data).
+  
+  \see setColumnData
+*/
+
 /* end of documentation of inline functions */
 
 /*!
@@ -20121,6 +22925,8 @@ QCPGraph::QCPGraph(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   setScatterSkip(0);
   setChannelFillGraph(0);
   setAdaptiveSampling(true);
+  setSamplingMethod(smMinMax);
+  setSamplingPointCount(0);
 }
 
 QCPGraph::~QCPGraph()
@@ -20145,6 +22951,9 @@ QCPGraph::~QCPGraph()
 void QCPGraph::setData(QSharedPointer<QCPGraphDataContainer> data)
 {
   mDataContainer = data;
+  mColumnData.clear();
+  mLineDataCache.clear();
+  markDirty();
 }
 
 /*! \overload
@@ -20156,12 +22965,75 @@ void QCPGraph::setData(QSharedPointer<QCPGraphDataContainer> data)
   If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
   can set \a alreadySorted to true, to improve performance by saving a sorting run.
   
+  The data points are copied into the data container. To display large, already sorted data sets
+  without copying them, wrap the vectors or buffers in data columns (\ref QCPDoubleColumn, \ref
+  QCPBufferColumn) and pass them to \ref setData(QSharedPointer<QCPDataColumn>,
+  QSharedPointer<QCPDataColumn>) instead.
+  
   \see addData
 */
 void QCPGraph::setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
 {
+  mColumnData.clear();
   mDataContainer->clear();
   addData(keys, values, alreadySorted);
+  markDirty();
+}
+
+/*! \overload
+  
+  Makes the graph display the data points formed by the columns \a keys and \a values, instead of
+  the data in its data container. The column \a keys must be sorted in ascending order. If the
+  columns have different sizes, the number of data points is the size of the smaller column.
+  
+  No samples are copied, the graph keeps shared references to the columns. Columns can therefore
+  also be shared between several graphs, e.g. a common key column for graphs that are sampled at
+  the same keys. Graphs sharing a key column search it for their visible key range only once per
+  replot (see \ref QCPDataColumn::cachedLowerBound). Caller-owned buffers can be displayed without
+  copying by wrapping them in a \ref QCPBufferColumn:
+  \code
+  QSharedPointer<QCPDataColumn> keys(new QCPBufferColumn(keyBuffer, size, keyBufferOwner));
+  QSharedPointer<QCPDataColumn> values(new QCPBufferColumn(valueBuffer, size, valueBufferOwner));
+  graph->setData(keys, values);
+  \endcode
+  
+  Samples in a narrower type than double, such as float or raw qint16 counts with a scale and
+  offset, can be kept in a \ref QCPScaledColumn. They are only converted to double as far as the
+  graph visits them while drawing, sampling and selecting:
+  \code
+  QSharedPointer<QCPDataColumn> volts(new QCPInt16Column(adcCounts, 10.0/32768.0, 0.0));
+  graph->setData(keys, volts);
+  \endcode
+  
+  This is a convenience method equivalent to calling \ref setColumnData with a new \ref
+  QCPGraphColumnData that holds \a keys and \a values.
+  
+  \see setColumnData
+*/
+void QCPGraph::setData(QSharedPointer<QCPDataColumn> keys, QSharedPointer<QCPDataColumn> values)
+{
+  setColumnData(QSharedPointer<QCPGraphColumnData>(new QCPGraphColumnData(keys, values)));
+  markDirty();
+}
+
+/*!
+  Makes the graph display the data points of the column data \a data instead of the data in its
+  data container. Passing a null pointer makes the graph display its data container again.
+  
+  Since a QSharedPointer is used, multiple QCPGraphs may share the same column data.
+  
+  While column data is set, the data container (see \ref data) is neither displayed nor modified
+  by \ref addData, which prints a debug warning and ignores the passed points. A data queue set
+  with \ref setDataQueue is still emptied into the data container at each replot, so the queued
+  points only become visible once the column data is removed again.
+  
+  \see columnData, setData
+*/
+void QCPGraph::setColumnData(QSharedPointer<QCPGraphColumnData> data)
+{
+  mColumnData = data;
+  mLineDataCache.clear();
+  markDirty();
 }
 
 /*!
@@ -20173,6 +23045,7 @@ void QCPGraph::setData(const QVector<double> &keys, const QVector<double> &value
 void QCPGraph::setLineStyle(LineStyle ls)
 {
   mLineStyle = ls;
+  markDirty();
 }
 
 /*!
@@ -20184,6 +23057,7 @@ void QCPGraph::setLineStyle(LineStyle ls)
 void QCPGraph::setScatterStyle(const QCPScatterStyle &style)
 {
   mScatterStyle = style;
+  markDirty();
 }
 
 /*!
@@ -20200,6 +23074,7 @@ void QCPGraph::setScatterStyle(const QCPScatterStyle &style)
 void QCPGraph::setScatterSkip(int skip)
 {
   mScatterSkip = qMax(0, skip);
+  markDirty();
 }
 
 /*!
@@ -20229,6 +23104,7 @@ void QCPGraph::setChannelFillGraph(QCPGraph *targetGraph)
   }
   
   mChannelFillGraph = targetGraph;
+  markDirty();
 }
 
 /*!
@@ -20261,10 +23137,50 @@ void QCPGraph::setChannelFillGraph(QCPGraph *targetGraph)
   sampling off. For example, when saving the plot to disk. This can be achieved by setting \a
   enabled to false before issuing a command like \ref QCustomPlot::savePng, and setting \a enabled
   back to true afterwards.
+  
+  The algorithm used for line plots can be chosen with \ref setSamplingMethod. For very large data
+  sets, the methods \ref smMinMax and \ref smM4 can be distributed over multiple threads with the
+  plotting hint \ref QCP::phParallelSampling.
 */
 void QCPGraph::setAdaptiveSampling(bool enabled)
 {
   mAdaptiveSampling = enabled;
+  markDirty();
+}
+
+/*!
+  Sets the algorithm that reduces the line points of this graph if adaptive sampling is enabled
+  (\ref setAdaptiveSampling).
+  
+  The default \ref smMinMax is the fastest method and suited for interactive use. \ref smM4 keeps
+  the first, minimum, maximum and last data point of each pixel column, which rasterizes
+  identically to the full data, but needs to visit every visible data point. \ref smLttb reduces
+  the data to a fixed number of points (\ref setSamplingPointCount) that preserve the visual shape.
+  This is useful for exports to vector formats such as PDF or SVG, where the number of vertices
+  determines the file size rather than the pixel resolution.
+  
+  With the step line styles, \ref smMinMax consolidates the data points in a step-aware way that
+  keeps the original step edges, see \ref sampleLineData. \ref smM4 and \ref smLttb are used
+  unchanged for the step line styles, since the points they keep retain their original keys.
+*/
+void QCPGraph::setSamplingMethod(QCPGraph::SamplingMethod method)
+{
+  mSamplingMethod = method;
+  markDirty();
+}
+
+/*!
+  Sets the number of points the data is reduced to with the sampling method \ref smLttb (see \ref
+  setSamplingMethod). The first and the last visible data point are always part of the result.
+  
+  If \a count is zero (the default), twice the number of pixels spanned by the visible data on the
+  key axis is used, which is also the threshold above which the other sampling methods become
+  active. Values between one and three are raised to three.
+*/
+void QCPGraph::setSamplingPointCount(int count)
+{
+  mSamplingPointCount = qMax(0, count);
+  markDirty();
 }
 
 /*! \overload
@@ -20278,9 +23194,17 @@ void QCPGraph::setAdaptiveSampling(bool enabled)
   
   Alternatively, you can also access and modify the data directly via the \ref data method, which
   returns a pointer to the internal data container.
+  
+  While column data is set (see \ref setColumnData), the data container isn't displayed, so this
+  method prints a debug warning and doesn't add the points.
 */
 void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
 {
+  if (mColumnData)
+  {
+    qDebug() << Q_FUNC_INFO << "can't add data while column data is set";
+    return;
+  }
   if (keys.size() != values.size())
     qDebug() << Q_FUNC_INFO << "keys and values have different sizes:" << keys.size() << values.size();
   const int n = qMin(keys.size(), values.size());
@@ -20296,6 +23220,7 @@ void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &value
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markDirty();
 }
 
 /*! \overload
@@ -20304,10 +23229,19 @@ void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &value
   
   Alternatively, you can also access and modify the data directly via the \ref data method, which
   returns a pointer to the internal data container.
+  
+  While column data is set (see \ref setColumnData), the data container isn't displayed, so this
+  method prints a debug warning and doesn't add the point.
 */
 void QCPGraph::addData(double key, double value)
 {
+  if (mColumnData)
+  {
+    qDebug() << Q_FUNC_INFO << "can't add data while column data is set";
+    return;
+  }
   mDataContainer->add(QCPGraphData(key, value));
+  markDirty();
 }
 
 /*!
@@ -20320,20 +23254,26 @@ void QCPGraph::addData(double key, double value)
 */
 double QCPGraph::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
 {
-  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+  if ((onlySelectable && mSelectable == QCP::stNone) || dataCount() == 0)
     return -1;
   if (!mKeyAxis || !mValueAxis)
     return -1;
   
   if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()))
   {
-    QCPGraphDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
-    double result = pointDistance(pos, closestDataPoint);
-    if (details)
+    double result;
+    int pointIndex;
+    if (mColumnData)
     {
-      int pointIndex = closestDataPoint-mDataContainer->constBegin();
-      details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
+      result = pointDistance(pos, pointIndex);
+    } else
+    {
+      QCPGraphDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
+      result = pointDistance(pos, closestDataPoint);
+      pointIndex = closestDataPoint-mDataContainer->constBegin();
     }
+    if (details)
+      details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
     return result;
   } else
     return -1;
@@ -20342,20 +23282,178 @@ double QCPGraph::selectTest(const QPointF &pos, bool onlySelectable, QVariant *d
 /* inherits documentation from base class */
 QCPRange QCPGraph::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
 {
+  if (mColumnData)
+    return mColumnData->keyRange(foundRange, inSignDomain);
   return mDataContainer->keyRange(foundRange, inSignDomain);
 }
 
 /* inherits documentation from base class */
 QCPRange QCPGraph::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
 {
+  if (mColumnData)
+    return mColumnData->valueRange(foundRange, inSignDomain, inKeyRange);
   return mDataContainer->valueRange(foundRange, inSignDomain, inKeyRange);
 }
 
+/*!
+  \copydoc QCPPlottableInterface1D::dataCount
+  
+  If column data is set (\ref setColumnData), this refers to the column data instead of the data
+  container. The same applies to the other methods of the 1D data interface.
+*/
+int QCPGraph::dataCount() const
+{
+  if (mColumnData)
+    return mColumnData->size();
+  return QCPAbstractPlottable1D<QCPGraphData>::dataCount();
+}
+
+/* inherits documentation from base class */
+double QCPGraph::dataMainKey(int index) const
+{
+  if (!mColumnData)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataMainKey(index);
+  
+  if (index >= 0 && index < mColumnData->size())
+  {
+    return mColumnData->key(index);
+  } else
+  {
+    qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+    return 0;
+  }
+}
+
+/* inherits documentation from base class */
+double QCPGraph::dataSortKey(int index) const
+{
+  if (!mColumnData)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataSortKey(index);
+  
+  if (index >= 0 && index < mColumnData->size())
+  {
+    return mColumnData->key(index);
+  } else
+  {
+    qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+    return 0;
+  }
+}
+
+/* inherits documentation from base class */
+double QCPGraph::dataMainValue(int index) const
+{
+  if (!mColumnData)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataMainValue(index);
+  
+  if (index >= 0 && index < mColumnData->size())
+  {
+    return mColumnData->value(index);
+  } else
+  {
+    qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+    return 0;
+  }
+}
+
+/* inherits documentation from base class */
+QCPRange QCPGraph::dataValueRange(int index) const
+{
+  if (!mColumnData)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataValueRange(index);
+  
+  if (index >= 0 && index < mColumnData->size())
+  {
+    const double value = mColumnData->value(index);
+    return QCPRange(value, value);
+  } else
+  {
+    qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+    return QCPRange(0, 0);
+  }
+}
+
+/* inherits documentation from base class */
+QPointF QCPGraph::dataPixelPosition(int index) const
+{
+  if (!mColumnData)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataPixelPosition(index);
+  
+  if (index >= 0 && index < mColumnData->size())
+  {
+    return coordsToPixels(mColumnData->key(index), mColumnData->value(index));
+  } else
+  {
+    qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+    return QPointF();
+  }
+}
+
+/* inherits documentation from base class */
+QCPDataSelection QCPGraph::selectTestRect(const QRectF &rect, bool onlySelectable) const
+{
+  if (!mColumnData)
+    return QCPAbstractPlottable1D<QCPGraphData>::selectTestRect(rect, onlySelectable);
+  
+  QCPDataSelection result;
+  if ((onlySelectable && mSelectable == QCP::stNone) || mColumnData->isEmpty())
+    return result;
+  if (!mKeyAxis || !mValueAxis)
+    return result;
+  
+  // convert rect given in pixels to ranges given in plot coordinates:
+  double key1, value1, key2, value2;
+  pixelsToCoords(rect.topLeft(), key1, value1);
+  pixelsToCoords(rect.bottomRight(), key2, value2);
+  QCPRange keyRange(key1, key2); // QCPRange normalizes internally so we don't have to care about whether key1 < key2
+  QCPRange valueRange(value1, value2);
+  // column data is sorted by key, so we can reduce the searched key interval:
+  const int begin = mColumnData->findBegin(keyRange.lower, false);
+  const int end = mColumnData->findEnd(keyRange.upper, false);
+  
+  int currentSegmentBegin = -1; // -1 means we're currently not in a segment that's contained in rect
+  for (int i=begin; i<end; ++i)
+  {
+    const bool contained = valueRange.contains(mColumnData->value(i)) && keyRange.contains(mColumnData->key(i));
+    if (currentSegmentBegin == -1)
+    {
+      if (contained) // start segment
+        currentSegmentBegin = i;
+    } else if (!contained) // segment just ended
+    {
+      result.addDataRange(QCPDataRange(currentSegmentBegin, i), false);
+      currentSegmentBegin = -1;
+    }
+  }
+  // process potential last segment:
+  if (currentSegmentBegin != -1)
+    result.addDataRange(QCPDataRange(currentSegmentBegin, end), false);
+  
+  result.simplify();
+  return result;
+}
+
+/* inherits documentation from base class */
+int QCPGraph::findBegin(double sortKey, bool expandedRange) const
+{
+  if (mColumnData)
+    return mColumnData->findBegin(sortKey, expandedRange);
+  return QCPAbstractPlottable1D<QCPGraphData>::findBegin(sortKey, expandedRange);
+}
+
+/* inherits documentation from base class */
+int QCPGraph::findEnd(double sortKey, bool expandedRange) const
+{
+  if (mColumnData)
+    return mColumnData->findEnd(sortKey, expandedRange);
+  return QCPAbstractPlottable1D<QCPGraphData>::findEnd(sortKey, expandedRange);
+}
+
 /* inherits documentation from base class */
 void QCPGraph::draw(QCPPainter *painter)
 {
   if (!mKeyAxis || !mValueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
-  if (mKeyAxis.data()->range().size() <= 0 || mDataContainer->isEmpty()) return;
+  if (mKeyAxis.data()->range().size() <= 0 || dataCount() == 0) return;
   if (mLineStyle == lsNone && mScatterStyle.isNone()) return;
   
   QVector<QPointF> lines, scatters; // line and (if necessary) scatter pixel coordinates will be stored here while iterating over segments
@@ -20477,18 +23575,35 @@ void QCPGraph::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
 void QCPGraph::getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const
 {
   if (!lines) return;
-  QCPGraphDataContainer::const_iterator begin, end;
-  getVisibleDataBounds(begin, end, dataRange);
-  if (begin == end)
+  QVector<QCPGraphData> lineData;
+  if (mColumnData)
   {
-    lines->clear();
-    return;
+    int begin, end;
+    getVisibleDataBounds(begin, end, dataRange);
+    if (begin == end)
+    {
+      lines->clear();
+      return;
+    }
+    if (mLineStyle != lsNone)
+    {
+      QVector<double> dataSignature;
+      dataSignature << mColumnData->keys()->revision() << mColumnData->values()->revision();
+      sampleLineDataCached(&lineData, *mColumnData, begin, end, dataSignature);
+    }
+  } else
+  {
+    QCPGraphDataContainer::const_iterator begin, end;
+    getVisibleDataBounds(begin, end, dataRange);
+    if (begin == end)
+    {
+      lines->clear();
+      return;
+    }
+    if (mLineStyle != lsNone)
+      getOptimizedLineData(&lineData, begin, end);
   }
   
-  QVector<QCPGraphData> lineData;
-  if (mLineStyle != lsNone)
-    getOptimizedLineData(&lineData, begin, end);
-  
   if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in lineData (significantly simplifies following processing)
     std::reverse(lineData.begin(), lineData.end());
 
@@ -20522,17 +23637,29 @@ void QCPGraph::getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataR
   QCPAxis *valueAxis = mValueAxis.data();
   if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; scatters->clear(); return; }
   
-  QCPGraphDataContainer::const_iterator begin, end;
-  getVisibleDataBounds(begin, end, dataRange);
-  if (begin == end)
+  QVector<QCPGraphData> data;
+  if (mColumnData)
   {
-    scatters->clear();
-    return;
+    int begin, end;
+    getVisibleDataBounds(begin, end, dataRange);
+    if (begin == end)
+    {
+      scatters->clear();
+      return;
+    }
+    sampleScatterData(&data, *mColumnData, begin, end);
+  } else
+  {
+    QCPGraphDataContainer::const_iterator begin, end;
+    getVisibleDataBounds(begin, end, dataRange);
+    if (begin == end)
+    {
+      scatters->clear();
+      return;
+    }
+    getOptimizedScatterData(&data, begin, end);
   }
   
-  QVector<QCPGraphData> data;
-  getOptimizedScatterData(&data, begin, end);
-  
   if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in data (significantly simplifies following processing)
     std::reverse(data.begin(), data.end());
   
@@ -20759,6 +23886,11 @@ QVector<QPointF> QCPGraph::dataToStepCenterLines(const QVector<QCPGraphData> &da
   Takes raw data points in plot coordinates as \a data, and returns a vector containing pixel
   coordinate points which are suitable for drawing the line style \ref lsImpulse.
   
+  Impulses whose keys fall into the same pixel column are merged into a single line, which spans
+  the values of all of them and the base line (see \ref getFillBasePoint). So the number of lines
+  is bounded by the number of pixel columns, even if adaptive sampling is disabled. Data points
+  with NaN values are skipped.
+  
   The source of \a data is usually \ref getOptimizedLineData, and this method is called in \a
   getLines if the line style is set accordingly.
 
@@ -20771,28 +23903,40 @@ QVector<QPointF> QCPGraph::dataToImpulseLines(const QVector<QCPGraphData> &data)
   QCPAxis *valueAxis = mValueAxis.data();
   if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
   
-  result.resize(data.size()*2);
+  result.reserve(data.size()*2);
+  const bool keyIsVertical = keyAxis->orientation() == Qt::Vertical;
+  // the base line is parallel to the key axis, so its value coordinate is the same for all impulses:
+  const QPointF basePoint = getFillBasePoint(QPointF(0, 0));
+  const double baseValue = keyIsVertical ? basePoint.x() : basePoint.y();
   
-  // transform data points to pixels:
-  if (keyAxis->orientation() == Qt::Vertical)
+  // transform data points to pixels, merging impulses of the same pixel column:
+  double column = 0;
+  for (int i=0; i<data.size(); ++i)
   {
-    for (int i=0; i<data.size(); ++i)
+    const double value = valueAxis->coordToPixel(data.at(i).value);
+    if (qIsNaN(value))
+      continue;
+    const double key = keyAxis->coordToPixel(data.at(i).key);
+    if (!result.isEmpty() && floor(key) == column) // same pixel column as the previous impulse, extend its line
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
-      result[i*2+0].setX(valueAxis->coordToPixel(0));
-      result[i*2+0].setY(key);
-      result[i*2+1].setX(valueAxis->coordToPixel(data.at(i).value));
-      result[i*2+1].setY(key);
-    }
-  } else // key axis is horizontal
-  {
-    for (int i=0; i<data.size(); ++i)
+      QPointF &lower = result[result.size()-2];
+      QPointF &upper = result[result.size()-1];
+      if (keyIsVertical)
+      {
+        lower.setX(qMin(lower.x(), value));
+        upper.setX(qMax(upper.x(), value));
+      } else
+      {
+        lower.setY(qMin(lower.y(), value));
+        upper.setY(qMax(upper.y(), value));
+      }
+    } else
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
-      result[i*2+0].setX(key);
-      result[i*2+0].setY(valueAxis->coordToPixel(0));
-      result[i*2+1].setX(key);
-      result[i*2+1].setY(valueAxis->coordToPixel(data.at(i).value));
+      column = floor(key);
+      if (keyIsVertical)
+        result << QPointF(qMin(baseValue, value), key) << QPointF(qMax(baseValue, value), key);
+      else
+        result << QPointF(key, qMin(baseValue, value)) << QPointF(key, qMax(baseValue, value));
     }
   }
   return result;
@@ -20902,11 +24046,135 @@ void QCPGraph::drawImpulsePlot(QCPPainter *painter, const QVector<QPointF> &line
   further by \a begin and \a end, e.g. to only plot a certain segment of the data (see \ref
   getDataSegments).
 
-  This method is used by \ref getLines to retrieve the basic working set of data.
+  This method is used by \ref getLines to retrieve the basic working set of data from the data
+  container. The sampling itself is performed by \ref sampleLineData, and its result is reused in
+  later replots as long as the data and the key axis didn't change (see \ref sampleLineDataCached).
 
   \see getOptimizedScatterData
 */
 void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGraphDataContainer::const_iterator &begin, const QCPGraphDataContainer::const_iterator &end) const
+{
+  const QCPGraphDataContainer::const_iterator dataBegin = mDataContainer->constBegin();
+  QVector<double> dataSignature;
+  dataSignature << double(quintptr(mDataContainer.data())) << mDataContainer->revision();
+  sampleLineDataCached(lineData, QCPGraphDataContainerSource(mDataContainer.data()), begin-dataBegin, end-dataBegin, dataSignature);
+}
+
+/*! \internal
+
+  Returns via \a scatterData the data points that need to be visualized for this graph when
+  plotting scatter points, taking into consideration the currently visible axis ranges and, if \ref
+  setAdaptiveSampling is enabled, local point densities. The considered data can be restricted
+  further by \a begin and \a end, e.g. to only plot a certain segment of the data (see \ref
+  getDataSegments).
+
+  This method is used by \ref getScatters to retrieve the basic working set of data from the data
+  container. The sampling itself is performed by \ref sampleScatterData.
+
+  \see getOptimizedLineData
+*/
+void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const
+{
+  const QCPGraphDataContainer::const_iterator dataBegin = mDataContainer->constBegin();
+  sampleScatterData(scatterData, QCPGraphDataContainerSource(mDataContainer.data()), begin-dataBegin, end-dataBegin);
+}
+
+/*! \internal
+
+  Returns the key under which the sampled line of the data points with indices from \a begin to \a
+  end (exclusive) is stored in the line data cache (see \ref sampleLineDataCached). \a
+  dataSignature identifies the data source and its revision.
+  
+  Besides the data, the sampled line only depends on the mapping of keys to pixels and on the
+  sampling properties of this graph. Of the value axis, only the scale type matters: \ref smLttb
+  compares triangle areas in pixel coordinates, but a change of the value axis range or size scales
+  all areas by the same factor and thus keeps the selected points. So a cached line remains valid
+  when only the value axis range changes.
+*/
+QVector<double> QCPGraph::lineDataSignature(int begin, int end, const QVector<double> &dataSignature) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  QVector<double> signature;
+  signature << begin << end << dataSignature
+            << double(quintptr(keyAxis)) << keyAxis->range().lower << keyAxis->range().upper
+            << keyAxis->coordToPixel(keyAxis->range().lower) << keyAxis->coordToPixel(keyAxis->range().upper) << keyAxis->scaleType()
+            << double(quintptr(valueAxis)) << valueAxis->scaleType()
+            << mLineStyle << mAdaptiveSampling << mSamplingMethod << mSamplingPointCount;
+  return signature;
+}
+
+/*! \internal
+
+  Performs \ref sampleLineData, reusing the result of a previous call if neither the data, the key
+  axis nor the sampling properties changed since then (see \ref lineDataSignature). This way,
+  replots in which only the value axis was dragged, or which were caused by other layerables, only
+  need to transform the sampled points to pixels again.
+  
+  Up to \c lineDataCacheSize sampled lines are kept, because a graph samples different data ranges
+  during one replot, e.g. for its selected and unselected segments. Only adaptively sampled lines
+  are cached, since otherwise the cache would duplicate all visible data points without saving
+  significant work.
+*/
+template <class DataSource>
+void QCPGraph::sampleLineDataCached(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end, const QVector<double> &dataSignature) const
+{
+  if (!mAdaptiveSampling || !mKeyAxis)
+  {
+    sampleLineData(lineData, source, begin, end);
+    return;
+  }
+  
+  const QVector<double> signature = lineDataSignature(begin, end, dataSignature);
+  for (int i=0; i<mLineDataCache.size(); ++i)
+  {
+    if (mLineDataCache.at(i).first == signature)
+    {
+      if (i > 0) // keep most recently used lines at the front
+        mLineDataCache.move(i, 0);
+      *lineData += mLineDataCache.first().second;
+      return;
+    }
+  }
+  
+  QVector<QCPGraphData> sampledData;
+  sampleLineData(&sampledData, source, begin, end);
+  mLineDataCache.prepend(qMakePair(signature, sampledData));
+  while (mLineDataCache.size() > lineDataCacheSize)
+    mLineDataCache.removeLast();
+  *lineData += sampledData;
+}
+
+/*! \internal
+
+  Performs the line sampling for \ref getOptimizedLineData and, if column data is set, for \ref
+  getLines. The data points with indices from \a begin to \a end (exclusive) are read from \a
+  source, which is either a \ref QCPGraphColumnData or an index based wrapper around the data
+  container. The sampled points are appended to \a lineData.
+
+  When adaptive sampling is used, the data points of each pixel interval aren't visited one by
+  one. The end of an interval is found by a short linear probe followed by a binary search, or
+  directly if the key column can calculate it (e.g. \ref QCPUniformColumn). The value extremes
+  inside the interval are retrieved from \a source, which uses the value range index of the data
+  container (see \ref QCPDataContainer::setValueRangeIndex) or a linear scan over the contiguous
+  value column, respectively. For the data container, this makes the cost of this method grow with
+  the number of key pixels times the logarithm of the number of data points, rather than with the
+  number of visible data points.
+  
+  For the step line styles, the points of a pixel interval are consolidated differently than for
+  \ref lsLine: The first and the last point of the interval are kept with their exact keys, and the
+  value extremes are inserted at the key of the first point. The step lines generated from this
+  (e.g. by \ref dataToStepLeftLines) then consist of one vertical segment per pixel column that
+  covers all values of the interval, connected by horizontal segments which begin and end at the
+  original step edges.
+  
+  The per-pixel consolidation described above belongs to the sampling method \ref smMinMax. With
+  \ref smM4, the first, minimum, maximum and last point of each pixel interval are kept with their
+  original keys instead, and \ref smLttb is delegated to \ref sampleLineDataLttb (see \ref
+  setSamplingMethod).
+*/
+template <class DataSource>
+void QCPGraph::sampleLineData(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end) const
 {
   if (!lineData) return;
   QCPAxis *keyAxis = mKeyAxis.data();
@@ -20918,87 +24186,375 @@ void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGr
   int maxCount = (std::numeric_limits<int>::max)();
   if (mAdaptiveSampling)
   {
-    double keyPixelSpan = qAbs(keyAxis->coordToPixel(begin->key)-keyAxis->coordToPixel((end-1)->key));
+    double keyPixelSpan = qAbs(keyAxis->coordToPixel(source.key(begin))-keyAxis->coordToPixel(source.key(end-1)));
     if (2*keyPixelSpan+2 < static_cast<double>((std::numeric_limits<int>::max)()))
       maxCount = 2*keyPixelSpan+2;
   }
   
-  if (mAdaptiveSampling && dataCount >= maxCount) // use adaptive sampling only if there are at least two points per pixel on average
+  const int lttbPointCount = mSamplingPointCount > 0 ? qMax(3, mSamplingPointCount) : qMax(3, maxCount);
+  if (mAdaptiveSampling && mSamplingMethod == smLttb && dataCount > lttbPointCount)
+  {
+    sampleLineDataLttb(lineData, source, begin, end, lttbPointCount);
+  } else if (mAdaptiveSampling && mSamplingMethod != smLttb && dataCount >= maxCount) // use adaptive sampling only if there are at least two points per pixel on average
   {
-    QCPGraphDataContainer::const_iterator it = begin;
-    double minValue = it->value;
-    double maxValue = it->value;
-    QCPGraphDataContainer::const_iterator currentIntervalFirstPoint = it;
     int reversedFactor = keyAxis->pixelOrientation(); // is used to calculate keyEpsilon pixel into the correct direction
     int reversedRound = reversedFactor==-1 ? 1 : 0; // is used to switch between floor (normal) and ceil (reversed) rounding of currentIntervalStartKey
-    double currentIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(begin->key)+reversedRound));
-    double lastIntervalEndKey = currentIntervalStartKey;
-    double keyEpsilon = qAbs(currentIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(currentIntervalStartKey)+1.0*reversedFactor)); // interval of one pixel on screen when mapped to plot key coordinates
-    bool keyEpsilonVariable = keyAxis->scaleType() == QCPAxis::stLogarithmic; // indicates whether keyEpsilon needs to be updated after every interval (for log axes)
-    int intervalDataCount = 1;
-    ++it; // advance iterator to second data point because adaptive sampling works in 1 point retrospect
-    while (it != end)
+    double firstIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(source.key(begin))+reversedRound));
+    double keyEpsilon = qAbs(firstIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(firstIntervalStartKey)+1.0*reversedFactor)); // interval of one pixel on screen when mapped to plot key coordinates
+    if (mParentPlot && mParentPlot->plottingHints().testFlag(QCP::phParallelSampling) && dataCount >= 2*minimumSamplingChunkSize)
+      sampleLineIntervalsInParallel(lineData, source, begin, end, keyEpsilon);
+    else
+      sampleLineIntervals(lineData, source, begin, end, begin, end, keyEpsilon, 0);
+  } else // don't use adaptive sampling algorithm, transfer points one-to-one from the data source into the output
+  {
+    lineData->resize(dataCount);
+    source.copy(begin, end, lineData->data());
+  }
+}
+
+/*! \internal
+
+  Performs the per-pixel consolidation of \ref sampleLineData (sampling methods \ref smMinMax and
+  \ref smM4) for the pixel intervals that begin at data indices from \a chunkBegin up to \a
+  chunkEnd (exclusive). \a chunkBegin must be the begin of a pixel interval, e.g. \a begin. The
+  last interval may extend beyond \a chunkEnd up to \a end, which together with \a begin delimits
+  the entire sampled data. The consolidated points are appended to \a lineData, and the index at
+  which the next interval begins is returned.
+  
+  \a keyEpsilon is the key width of one pixel at the first interval of the entire sampled data. For
+  logarithmic key axes, it is recalculated at each interval instead.
+  
+  If \a intervals is non-zero, the begin index of each interval and the size of \a lineData before
+  the interval was appended are recorded in it. The output for an interval only depends on the
+  interval's begin index, so \ref sampleLineIntervalsInParallel can use this to stitch chunks
+  together that were sampled independently.
+*/
+template <class DataSource>
+int QCPGraph::sampleLineIntervals(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end, int chunkBegin, int chunkEnd, double keyEpsilon, QVector<QPair<int, int> > *intervals) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  const int linearProbeCount = source.hasConstantTimeSearch() ? 0 : 16; // number of points to check individually before searching the interval end
+  int intervalBegin = chunkBegin;
+  int reversedFactor = keyAxis->pixelOrientation(); // is used to calculate keyEpsilon pixel into the correct direction
+  int reversedRound = reversedFactor==-1 ? 1 : 0; // is used to switch between floor (normal) and ceil (reversed) rounding of currentIntervalStartKey
+  double currentIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(source.key(intervalBegin))+reversedRound));
+  double lastIntervalEndKey = intervalBegin == begin ? currentIntervalStartKey : source.key(intervalBegin-1);
+  bool keyEpsilonVariable = keyAxis->scaleType() == QCPAxis::stLogarithmic; // indicates whether keyEpsilon needs to be updated after every interval (for log axes)
+  if (keyEpsilonVariable)
+    keyEpsilon = qAbs(currentIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(currentIntervalStartKey)+1.0*reversedFactor));
+  const bool stepStyle = mLineStyle == lsStepLeft || mLineStyle == lsStepRight || mLineStyle == lsStepCenter;
+  while (intervalBegin < chunkEnd)
+  {
+    if (intervals)
+      intervals->append(qMakePair(intervalBegin, lineData->size()));
+    
+    // find the first data point that lies beyond the current pixel interval:
+    const double intervalEndKey = currentIntervalStartKey+keyEpsilon;
+    int intervalEnd = intervalBegin+1;
+    int probeCount = 0;
+    while (intervalEnd != end && source.key(intervalEnd) < intervalEndKey && probeCount < linearProbeCount)
+    {
+      ++intervalEnd;
+      ++probeCount;
+    }
+    if (probeCount == linearProbeCount && intervalEnd != end && source.key(intervalEnd) < intervalEndKey) // dense interval, skip the remaining points via binary search
+      intervalEnd = source.lowerBound(intervalEndKey, intervalEnd, end);
+    
+    const double firstValue = source.value(intervalBegin);
+    if (intervalEnd-intervalBegin >= 2 && mSamplingMethod == smM4) // keep first, minimum, maximum and last point of the pixel with their original keys
     {
-      if (it->key < currentIntervalStartKey+keyEpsilon) // data point is still within same pixel, so skip it and expand value span of this cluster if necessary
+      int minIndex = -1;
+      int maxIndex = -1;
+      for (int i=intervalBegin; i<intervalEnd; ++i)
       {
-        if (it->value < minValue)
-          minValue = it->value;
-        else if (it->value > maxValue)
-          maxValue = it->value;
-        ++intervalDataCount;
-      } else // new pixel interval started
+        const double value = source.value(i);
+        if (qIsNaN(value))
+          continue;
+        if (minIndex < 0 || value < source.value(minIndex))
+          minIndex = i;
+        if (maxIndex < 0 || value > source.value(maxIndex))
+          maxIndex = i;
+      }
+      const int indices[4] = {intervalBegin, qMin(minIndex, maxIndex), qMax(minIndex, maxIndex), intervalEnd-1};
+      int lastIndex = -1;
+      for (int k=0; k<4; ++k)
       {
-        if (intervalDataCount >= 2) // last pixel had multiple data points, consolidate them to a cluster
+        if (indices[k] > lastIndex) // skip extremes that coincide with other kept points, and all-NaN pixels (index -1)
         {
-          if (lastIntervalEndKey < currentIntervalStartKey-keyEpsilon) // last point is further away, so first point of this cluster must be at a real data point
-            lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.2, currentIntervalFirstPoint->value));
-          lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.25, minValue));
-          lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.75, maxValue));
-          if (it->key > currentIntervalStartKey+keyEpsilon*2) // new pixel started further away from previous cluster, so make sure the last point of the cluster is at a real data point
-            lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.8, (it-1)->value));
-        } else
-          lineData->append(QCPGraphData(currentIntervalFirstPoint->key, currentIntervalFirstPoint->value));
-        lastIntervalEndKey = (it-1)->key;
-        minValue = it->value;
-        maxValue = it->value;
-        currentIntervalFirstPoint = it;
-        currentIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(it->key)+reversedRound));
-        if (keyEpsilonVariable)
-          keyEpsilon = qAbs(currentIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(currentIntervalStartKey)+1.0*reversedFactor));
-        intervalDataCount = 1;
+          lineData->append(source.at(indices[k]));
+          lastIndex = indices[k];
+        }
       }
-      ++it;
-    }
-    // handle last interval:
-    if (intervalDataCount >= 2) // last pixel had multiple data points, consolidate them to a cluster
+    } else if (intervalEnd-intervalBegin >= 2) // pixel has multiple data points, consolidate them to a cluster
     {
-      if (lastIntervalEndKey < currentIntervalStartKey-keyEpsilon) // last point wasn't a cluster, so first point of this cluster must be at a real data point
-        lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.2, currentIntervalFirstPoint->value));
-      lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.25, minValue));
-      lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.75, maxValue));
+      // value extremes of the cluster, a NaN first point propagates like in a sequential min/max scan starting at that point:
+      double minValue = firstValue;
+      double maxValue = firstValue;
+      if (!qIsNaN(firstValue))
+      {
+        bool foundRange;
+        const QCPRange intervalValueRange = source.valueRange(foundRange, intervalBegin, intervalEnd);
+        minValue = intervalValueRange.lower;
+        maxValue = intervalValueRange.upper;
+      }
+      if (stepStyle) // keep the step edges at the cluster boundaries on the real data keys
+      {
+        const double firstKey = source.key(intervalBegin);
+        const double lastValue = source.value(intervalEnd-1);
+        lineData->append(QCPGraphData(firstKey, firstValue));
+        if (qAbs(maxValue-lastValue) <= qAbs(minValue-lastValue)) // visit the extreme closer to the last value last, so the vertical segment doesn't double back
+        {
+          lineData->append(QCPGraphData(firstKey, minValue));
+          lineData->append(QCPGraphData(firstKey, maxValue));
+        } else
+        {
+          lineData->append(QCPGraphData(firstKey, maxValue));
+          lineData->append(QCPGraphData(firstKey, minValue));
+        }
+        lineData->append(QCPGraphData(source.key(intervalEnd-1), lastValue));
+      } else
+      {
+        if (lastIntervalEndKey < currentIntervalStartKey-keyEpsilon) // last point is further away, so first point of this cluster must be at a real data point
+          lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.2, firstValue));
+        lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.25, minValue));
+        lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.75, maxValue));
+        if (intervalEnd != end && source.key(intervalEnd) > currentIntervalStartKey+keyEpsilon*2) // new pixel started further away from previous cluster, so make sure the last point of the cluster is at a real data point
+          lineData->append(QCPGraphData(currentIntervalStartKey+keyEpsilon*0.8, source.value(intervalEnd-1)));
+      }
     } else
-      lineData->append(QCPGraphData(currentIntervalFirstPoint->key, currentIntervalFirstPoint->value));
+      lineData->append(QCPGraphData(source.key(intervalBegin), firstValue));
     
-  } else // don't use adaptive sampling algorithm, transfer points one-to-one from the data container into the output
+    // start next pixel interval:
+    lastIntervalEndKey = source.key(intervalEnd-1);
+    intervalBegin = intervalEnd;
+    if (intervalBegin != end)
+    {
+      currentIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(source.key(intervalBegin))+reversedRound));
+      if (keyEpsilonVariable)
+        keyEpsilon = qAbs(currentIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(currentIntervalStartKey)+1.0*reversedFactor));
+    }
+  }
+  return intervalBegin;
+}
+
+/*! \internal
+
+  Performs \ref sampleLineIntervals for the entire data range \a begin to \a end concurrently, if
+  the plotting hint \ref QCP::phParallelSampling is set.
+  
+  The visible key range is split at whole pixels into chunks of at least \c
+  minimumSamplingChunkSize data points, one chunk per thread of the render thread pool of the parent
+  plot. Each chunk is sampled independently by a \ref QCPGraphSamplingTask, assuming that a pixel
+  interval begins at the first data point of the chunk. The calling thread samples chunks, too.
+  
+  Since the pixel intervals are determined by the data (an interval begins at the first data point
+  beyond the previous one), a chunk start found this way might not coincide with the interval begin
+  of the serial algorithm, e.g. due to rounding. The chunks are therefore stitched together by
+  following the serial sequence of interval begins: A chunk's output is used from the interval at
+  which the previous chunk ended. If no interval of the chunk begins there, the chunk is sampled
+  again from that index in the calling thread. The output is thus always identical to the serial
+  algorithm.
+  
+  The data source must be safe for concurrent reads, see \ref QCPDataColumn::valueAt.
+*/
+template <class DataSource>
+void QCPGraph::sampleLineIntervalsInParallel(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end, double keyEpsilon) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QThreadPool *threadPool = mParentPlot->mRenderThreadPool;
+  const int chunkCount = qMin(threadPool->maxThreadCount(), (end-begin)/minimumSamplingChunkSize);
+  if (chunkCount < 2)
   {
-    lineData->resize(dataCount);
-    std::copy(begin, end, lineData->begin());
+    sampleLineIntervals(lineData, source, begin, end, begin, end, keyEpsilon, 0);
+    return;
+  }
+  
+  // split the data at whole pixels of the key axis:
+  QVector<QCPGraphSamplingChunk> chunks;
+  const double firstPixel = keyAxis->coordToPixel(source.key(begin));
+  const double lastPixel = keyAxis->coordToPixel(source.key(end-1));
+  int chunkBegin = begin;
+  for (int i=1; i<=chunkCount; ++i)
+  {
+    int chunkEnd = end;
+    if (i < chunkCount)
+    {
+      const double boundaryKey = keyAxis->pixelToCoord((int)(firstPixel+(lastPixel-firstPixel)*i/double(chunkCount)));
+      chunkEnd = qBound(chunkBegin, source.lowerBound(boundaryKey, chunkBegin, end), end);
+    }
+    if (chunkEnd > chunkBegin)
+    {
+      QCPGraphSamplingChunk chunk;
+      chunk.begin = chunkBegin;
+      chunk.end = chunkEnd;
+      chunk.next = chunkEnd;
+      chunks.append(chunk);
+      chunkBegin = chunkEnd;
+    }
+  }
+  
+  // sample the chunks concurrently:
+  qcpPrepareConcurrentReads(source, begin, end);
+  QAtomicInt nextChunk(0);
+  QSemaphore finished;
+  QCPGraphSamplingChunk *chunkData = chunks.data(); // detach in this thread, the tasks only write to the individual chunks
+  QCPGraphSamplingTask<DataSource> localTask(this, &source, begin, end, keyEpsilon, chunkData, chunks.size(), &nextChunk, &finished);
+  QVector<QCPGraphSamplingTask<DataSource>*> helperTasks;
+  for (int i=1; i<chunks.size(); ++i)
+  {
+    helperTasks.append(new QCPGraphSamplingTask<DataSource>(this, &source, begin, end, keyEpsilon, chunkData, chunks.size(), &nextChunk, &finished));
+    threadPool->start(helperTasks.last());
+  }
+  localTask.processChunks();
+  int startedTasks = helperTasks.size();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+  for (int i=0; i<helperTasks.size(); ++i) // all chunks are taken, so tasks that haven't started yet (e.g. due to a running background render task) are obsolete
+  {
+    if (threadPool->tryTake(helperTasks.at(i)))
+      --startedTasks;
+  }
+#endif
+  finished.acquire(startedTasks);
+  qDeleteAll(helperTasks);
+  
+  // stitch the chunks together along the serial sequence of interval begins:
+  int intervalBegin = begin;
+  for (int i=0; i<chunks.size(); ++i)
+  {
+    const QCPGraphSamplingChunk &chunk = chunks.at(i);
+    if (intervalBegin >= chunk.end) // an interval of a previous chunk extended beyond this chunk
+      continue;
+    QVector<QPair<int, int> >::const_iterator it = std::lower_bound(chunk.intervals.constBegin(), chunk.intervals.constEnd(), qMakePair(intervalBegin, 0));
+    if (it != chunk.intervals.constEnd() && it->first == intervalBegin)
+    {
+      lineData->reserve(lineData->size()+chunk.lineData.size()-it->second);
+      for (int k=it->second; k<chunk.lineData.size(); ++k)
+        lineData->append(chunk.lineData.at(k));
+      intervalBegin = chunk.next;
+    } else
+      intervalBegin = sampleLineIntervals(lineData, source, begin, end, intervalBegin, chunk.end, keyEpsilon, 0);
   }
 }
 
 /*! \internal
 
-  Returns via \a scatterData the data points that need to be visualized for this graph when
-  plotting scatter points, taking into consideration the currently visible axis ranges and, if \ref
-  setAdaptiveSampling is enabled, local point densities. The considered data can be restricted
-  further by \a begin and \a end, e.g. to only plot a certain segment of the data (see \ref
-  getDataSegments).
+  Performs the line sampling for \ref sampleLineData with the sampling method \ref smLttb
+  (Largest-Triangle-Three-Buckets). The data points with indices from \a begin to \a end
+  (exclusive) are read from \a source and reduced to \a pointCount points, which are appended to \a
+  lineData. \a pointCount must be at least three and smaller than the number of data points.
+  
+  The first and the last point are kept. The points in between are divided into buckets of equal
+  size, and from each bucket the point is kept that spans the largest triangle with the previously
+  kept point and the average of the next bucket. The triangle areas are calculated in pixel
+  coordinates, so both axes are weighted like on screen. Data points with NaN values don't take part
+  in the selection, but the first one of each bucket is kept as well, so gaps in the line remain
+  visible. As long as no point with a valid value was kept (i.e. the line begins with NaN values),
+  there is no triangle corner to measure against, so the first valid point of the bucket is kept.
+*/
+template <class DataSource>
+void QCPGraph::sampleLineDataLttb(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end, int pointCount) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  
+  const int bucketCount = pointCount-2;
+  const double bucketSize = (end-begin-2)/double(bucketCount);
+  lineData->reserve(lineData->size()+pointCount);
+  lineData->append(source.at(begin));
+  bool keptValid = !qIsNaN(source.value(begin));
+  double keptKey = 0;
+  double keptValue = 0;
+  if (keptValid)
+  {
+    keptKey = keyAxis->coordToPixel(source.key(begin));
+    keptValue = valueAxis->coordToPixel(source.value(begin));
+  }
+  int bucketBegin = begin+1;
+  for (int bucket=0; bucket<bucketCount; ++bucket)
+  {
+    const int bucketEnd = bucket == bucketCount-1 ? end-1 : begin+1+int((bucket+1)*bucketSize);
+    int nextEnd = end; // the last bucket is followed by the last data point
+    if (bucket == bucketCount-2)
+      nextEnd = end-1;
+    else if (bucket < bucketCount-2)
+      nextEnd = begin+1+int((bucket+2)*bucketSize);
+    
+    // average of the next bucket, which is the third corner of the triangles:
+    double averageKey = 0;
+    double averageValue = 0;
+    int averageCount = 0;
+    for (int i=bucketEnd; i<nextEnd; ++i)
+    {
+      const double value = source.value(i);
+      if (!qIsNaN(value))
+      {
+        averageKey += keyAxis->coordToPixel(source.key(i));
+        averageValue += valueAxis->coordToPixel(value);
+        ++averageCount;
+      }
+    }
+    if (averageCount > 0)
+    {
+      averageKey /= averageCount;
+      averageValue /= averageCount;
+    } else // next bucket has no valid points, fall back to a flat triangle base
+    {
+      averageKey = keptKey;
+      averageValue = keptValue;
+    }
+    
+    // find the point of this bucket with the largest triangle area:
+    int bestIndex = -1;
+    int nanIndex = -1;
+    double bestArea = -1;
+    double bestKey = 0;
+    double bestValue = 0;
+    for (int i=bucketBegin; i<bucketEnd; ++i)
+    {
+      const double value = source.value(i);
+      if (qIsNaN(value))
+      {
+        if (nanIndex < 0)
+          nanIndex = i;
+        continue;
+      }
+      const double pointKey = keyAxis->coordToPixel(source.key(i));
+      const double pointValue = valueAxis->coordToPixel(value);
+      const double area = keptValid ? qAbs((keptKey-averageKey)*(pointValue-keptValue) - (keptKey-pointKey)*(averageValue-keptValue)) : 0; // twice the triangle area
+      if (bestIndex < 0 || area > bestArea)
+      {
+        bestArea = area;
+        bestIndex = i;
+        bestKey = pointKey;
+        bestValue = pointValue;
+      }
+    }
+    
+    if (nanIndex >= 0 && (bestIndex < 0 || nanIndex < bestIndex))
+      lineData->append(source.at(nanIndex));
+    if (bestIndex >= 0)
+    {
+      lineData->append(source.at(bestIndex));
+      keptValid = true;
+      keptKey = bestKey;
+      keptValue = bestValue;
+    }
+    if (nanIndex > bestIndex && bestIndex >= 0)
+      lineData->append(source.at(nanIndex));
+    bucketBegin = bucketEnd;
+  }
+  lineData->append(source.at(end-1));
+}
 
-  This method is used by \ref getScatters to retrieve the basic working set of data.
+/*! \internal
 
-  \see getOptimizedLineData
+  Performs the scatter sampling for \ref getOptimizedScatterData and, if column data is set, for
+  \ref getScatters. The data points with indices from \a begin to \a end (exclusive) are read from
+  \a source, which is either a \ref QCPGraphColumnData or an index based wrapper around the data
+  container. The sampled points are appended to \a scatterData.
 */
-void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const
+template <class DataSource>
+void QCPGraph::sampleScatterData(QVector<QCPGraphData> *scatterData, const DataSource &source, int begin, int end) const
 {
   if (!scatterData) return;
   QCPAxis *keyAxis = mKeyAxis.data();
@@ -21007,19 +24563,14 @@ void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGr
   
   const int scatterModulo = mScatterSkip+1;
   const bool doScatterSkip = mScatterSkip > 0;
-  int beginIndex = begin-mDataContainer->constBegin();
-  int endIndex = end-mDataContainer->constBegin();
-  while (doScatterSkip && begin != end && beginIndex % scatterModulo != 0) // advance begin iterator to first non-skipped scatter
-  {
-    ++beginIndex;
+  while (doScatterSkip && begin != end && begin % scatterModulo != 0) // advance begin index to first non-skipped scatter
     ++begin;
-  }
   if (begin == end) return;
   int dataCount = end-begin;
   int maxCount = (std::numeric_limits<int>::max)();
   if (mAdaptiveSampling)
   {
-    int keyPixelSpan = qAbs(keyAxis->coordToPixel(begin->key)-keyAxis->coordToPixel((end-1)->key));
+    int keyPixelSpan = qAbs(keyAxis->coordToPixel(source.key(begin))-keyAxis->coordToPixel(source.key(end-1)));
     maxCount = 2*keyPixelSpan+2;
   }
   
@@ -21027,45 +24578,40 @@ void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGr
   {
     double valueMaxRange = valueAxis->range().upper;
     double valueMinRange = valueAxis->range().lower;
-    QCPGraphDataContainer::const_iterator it = begin;
-    int itIndex = beginIndex;
-    double minValue = it->value;
-    double maxValue = it->value;
-    QCPGraphDataContainer::const_iterator minValueIt = it;
-    QCPGraphDataContainer::const_iterator maxValueIt = it;
-    QCPGraphDataContainer::const_iterator currentIntervalStart = it;
+    int it = begin;
+    double minValue = source.value(it);
+    double maxValue = source.value(it);
+    int minValueIt = it;
+    int maxValueIt = it;
+    int currentIntervalStart = it;
     int reversedFactor = keyAxis->pixelOrientation(); // is used to calculate keyEpsilon pixel into the correct direction
     int reversedRound = reversedFactor==-1 ? 1 : 0; // is used to switch between floor (normal) and ceil (reversed) rounding of currentIntervalStartKey
-    double currentIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(begin->key)+reversedRound));
+    double currentIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(source.key(begin))+reversedRound));
     double keyEpsilon = qAbs(currentIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(currentIntervalStartKey)+1.0*reversedFactor)); // interval of one pixel on screen when mapped to plot key coordinates
     bool keyEpsilonVariable = keyAxis->scaleType() == QCPAxis::stLogarithmic; // indicates whether keyEpsilon needs to be updated after every interval (for log axes)
     int intervalDataCount = 1;
-    // advance iterator to second (non-skipped) data point because adaptive sampling works in 1 point retrospect:
+    // advance index to second (non-skipped) data point because adaptive sampling works in 1 point retrospect:
     if (!doScatterSkip)
       ++it;
     else
     {
-      itIndex += scatterModulo;
-      if (itIndex < endIndex) // make sure we didn't jump over end
-        it += scatterModulo;
-      else
-      {
+      it += scatterModulo;
+      if (it > end) // make sure we didn't jump over end
         it = end;
-        itIndex = endIndex;
-      }
     }
     // main loop over data points:
     while (it != end)
     {
-      if (it->key < currentIntervalStartKey+keyEpsilon) // data point is still within same pixel, so skip it and expand value span of this pixel if necessary
+      const double currentValue = source.value(it);
+      if (source.key(it) < currentIntervalStartKey+keyEpsilon) // data point is still within same pixel, so skip it and expand value span of this pixel if necessary
       {
-        if (it->value < minValue && it->value > valueMinRange && it->value < valueMaxRange)
+        if (currentValue < minValue && currentValue > valueMinRange && currentValue < valueMaxRange)
         {
-          minValue = it->value;
+          minValue = currentValue;
           minValueIt = it;
-        } else if (it->value > maxValue && it->value > valueMinRange && it->value < valueMaxRange)
+        } else if (currentValue > maxValue && currentValue > valueMinRange && currentValue < valueMaxRange)
         {
-          maxValue = it->value;
+          maxValue = currentValue;
           maxValueIt = it;
         }
         ++intervalDataCount;
@@ -21076,24 +24622,25 @@ void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGr
           // determine value pixel span and add as many points in interval to maintain certain vertical data density (this is specific to scatter plot):
           double valuePixelSpan = qAbs(valueAxis->coordToPixel(minValue)-valueAxis->coordToPixel(maxValue));
           int dataModulo = qMax(1, qRound(intervalDataCount/(valuePixelSpan/4.0))); // approximately every 4 value pixels one data point on average
-          QCPGraphDataContainer::const_iterator intervalIt = currentIntervalStart;
+          int intervalIt = currentIntervalStart;
           int c = 0;
           while (intervalIt != it)
           {
-            if ((c % dataModulo == 0 || intervalIt == minValueIt || intervalIt == maxValueIt) && intervalIt->value > valueMinRange && intervalIt->value < valueMaxRange)
-              scatterData->append(*intervalIt);
+            const double intervalValue = source.value(intervalIt);
+            if ((c % dataModulo == 0 || intervalIt == minValueIt || intervalIt == maxValueIt) && intervalValue > valueMinRange && intervalValue < valueMaxRange)
+              scatterData->append(source.at(intervalIt));
             ++c;
             if (!doScatterSkip)
               ++intervalIt;
             else
               intervalIt += scatterModulo; // since we know indices of "currentIntervalStart", "intervalIt" and "it" are multiples of scatterModulo, we can't accidentally jump over "it" here
           }
-        } else if (currentIntervalStart->value > valueMinRange && currentIntervalStart->value < valueMaxRange)
-          scatterData->append(*currentIntervalStart);
-        minValue = it->value;
-        maxValue = it->value;
+        } else if (source.value(currentIntervalStart) > valueMinRange && source.value(currentIntervalStart) < valueMaxRange)
+          scatterData->append(source.at(currentIntervalStart));
+        minValue = currentValue;
+        maxValue = currentValue;
         currentIntervalStart = it;
-        currentIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(it->key)+reversedRound));
+        currentIntervalStartKey = keyAxis->pixelToCoord((int)(keyAxis->coordToPixel(source.key(it))+reversedRound));
         if (keyEpsilonVariable)
           keyEpsilon = qAbs(currentIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(currentIntervalStartKey)+1.0*reversedFactor));
         intervalDataCount = 1;
@@ -21103,14 +24650,9 @@ void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGr
         ++it;
       else
       {
-        itIndex += scatterModulo;
-        if (itIndex < endIndex) // make sure we didn't jump over end
-          it += scatterModulo;
-        else
-        {
+        it += scatterModulo;
+        if (it > end) // make sure we didn't jump over end
           it = end;
-          itIndex = endIndex;
-        }
       }
     }
     // handle last interval:
@@ -21119,52 +24661,41 @@ void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGr
       // determine value pixel span and add as many points in interval to maintain certain vertical data density (this is specific to scatter plot):
       double valuePixelSpan = qAbs(valueAxis->coordToPixel(minValue)-valueAxis->coordToPixel(maxValue));
       int dataModulo = qMax(1, qRound(intervalDataCount/(valuePixelSpan/4.0))); // approximately every 4 value pixels one data point on average
-      QCPGraphDataContainer::const_iterator intervalIt = currentIntervalStart;
-      int intervalItIndex = intervalIt-mDataContainer->constBegin();
+      int intervalIt = currentIntervalStart;
       int c = 0;
       while (intervalIt != it)
       {
-        if ((c % dataModulo == 0 || intervalIt == minValueIt || intervalIt == maxValueIt) && intervalIt->value > valueMinRange && intervalIt->value < valueMaxRange)
-          scatterData->append(*intervalIt);
+        const double intervalValue = source.value(intervalIt);
+        if ((c % dataModulo == 0 || intervalIt == minValueIt || intervalIt == maxValueIt) && intervalValue > valueMinRange && intervalValue < valueMaxRange)
+          scatterData->append(source.at(intervalIt));
         ++c;
         if (!doScatterSkip)
           ++intervalIt;
-        else // here we can't guarantee that adding scatterModulo doesn't exceed "it" (because "it" is equal to "end" here, and "end" isn't scatterModulo-aligned), so check via index comparison:
+        else // here we can't guarantee that adding scatterModulo doesn't exceed "it" (because "it" is equal to "end" here, and "end" isn't scatterModulo-aligned), so limit it:
         {
-          intervalItIndex += scatterModulo;
-          if (intervalItIndex < itIndex)
-            intervalIt += scatterModulo;
-          else
-          {
+          intervalIt += scatterModulo;
+          if (intervalIt > it)
             intervalIt = it;
-            intervalItIndex = itIndex;
-          }
         }
       }
-    } else if (currentIntervalStart->value > valueMinRange && currentIntervalStart->value < valueMaxRange)
-      scatterData->append(*currentIntervalStart);
+    } else if (source.value(currentIntervalStart) > valueMinRange && source.value(currentIntervalStart) < valueMaxRange)
+      scatterData->append(source.at(currentIntervalStart));
     
-  } else // don't use adaptive sampling algorithm, transfer points one-to-one from the data container into the output
+  } else // don't use adaptive sampling algorithm, transfer points one-to-one from the data source into the output
   {
-    QCPGraphDataContainer::const_iterator it = begin;
-    int itIndex = beginIndex;
+    int it = begin;
     scatterData->reserve(dataCount);
     while (it != end)
     {
-      scatterData->append(*it);
+      scatterData->append(source.at(it));
       // advance to next data point:
       if (!doScatterSkip)
         ++it;
       else
       {
-        itIndex += scatterModulo;
-        if (itIndex < endIndex)
-          it += scatterModulo;
-        else
-        {
+        it += scatterModulo;
+        if (it > end)
           it = end;
-          itIndex = endIndex;
-        }
       }
     }
   }
@@ -21198,6 +24729,32 @@ void QCPGraph::getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin
   }
 }
 
+/*! \overload
+
+  This is the index based counterpart of the above method, used when the graph displays column
+  data (\ref setColumnData).
+*/
+void QCPGraph::getVisibleDataBounds(int &begin, int &end, const QCPDataRange &rangeRestriction) const
+{
+  if (rangeRestriction.isEmpty() || !mColumnData)
+  {
+    end = dataCount();
+    begin = end;
+  } else
+  {
+    QCPAxis *keyAxis = mKeyAxis.data();
+    QCPAxis *valueAxis = mValueAxis.data();
+    if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; begin = end = 0; return; }
+    // get visible data range, graphs sharing the key column reuse the search results of the current replot:
+    const uint cacheSerial = mParentPlot && mParentPlot->mReplotting ? mParentPlot->mReplotSerial : 0;
+    QCPDataRange visibleRange(mColumnData->findBegin(keyAxis->range().lower, true, cacheSerial), mColumnData->findEnd(keyAxis->range().upper, true, cacheSerial));
+    // limit to rangeRestriction, this also ensures rangeRestriction outside data bounds doesn't break anything:
+    visibleRange = visibleRange.bounded(rangeRestriction.bounded(mColumnData->dataRange()));
+    begin = visibleRange.begin();
+    end = visibleRange.end();
+  }
+}
+
 /*!  \internal
   
   This method goes through the passed points in \a lineData and returns a list of the segments
@@ -21680,6 +25237,60 @@ double QCPGraph::pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer:
   return qSqrt(minDistSqr);
 }
 
+/*! \internal
+  
+  This is the index based counterpart of the above method, used when the graph displays column
+  data (\ref setColumnData). The index of the closest data point is returned via \a
+  closestDataIndex. If no data point qualifies, it is set to \ref dataCount.
+*/
+double QCPGraph::pointDistance(const QPointF &pixelPoint, int &closestDataIndex) const
+{
+  closestDataIndex = dataCount();
+  if (!mColumnData || mColumnData->isEmpty())
+    return -1.0;
+  if (mLineStyle == lsNone && mScatterStyle.isNone())
+    return -1.0;
+  
+  // calculate minimum distances to graph data points and find closestDataIndex:
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  // determine which key range comes into question, taking selection tolerance around pos into account:
+  double posKeyMin, posKeyMax, dummy;
+  pixelsToCoords(pixelPoint-QPointF(mParentPlot->selectionTolerance(), mParentPlot->selectionTolerance()), posKeyMin, dummy);
+  pixelsToCoords(pixelPoint+QPointF(mParentPlot->selectionTolerance(), mParentPlot->selectionTolerance()), posKeyMax, dummy);
+  if (posKeyMin > posKeyMax)
+    qSwap(posKeyMin, posKeyMax);
+  // iterate over found data points and then choose the one with the shortest distance to pos:
+  const int begin = mColumnData->findBegin(posKeyMin, true);
+  const int end = mColumnData->findEnd(posKeyMax, true);
+  for (int i=begin; i<end; ++i)
+  {
+    const double currentDistSqr = QCPVector2D(coordsToPixels(mColumnData->key(i), mColumnData->value(i))-pixelPoint).lengthSquared();
+    if (currentDistSqr < minDistSqr)
+    {
+      minDistSqr = currentDistSqr;
+      closestDataIndex = i;
+    }
+  }
+  
+  // calculate distance to graph line if there is one (if so, will probably be smaller than distance to closest data point):
+  if (mLineStyle != lsNone)
+  {
+    // line displayed, calculate distance to line segments:
+    QVector<QPointF> lineData;
+    getLines(&lineData, QCPDataRange(0, dataCount()));
+    QCPVector2D p(pixelPoint);
+    const int step = mLineStyle==lsImpulse ? 2 : 1; // impulse plot differs from other line styles in that the lineData points are only pairwise connected
+    for (int i=0; i<lineData.size()-1; i+=step)
+    {
+      const double currentDistSqr = p.distanceSquaredToLine(lineData.at(i), lineData.at(i+1));
+      if (currentDistSqr < minDistSqr)
+        minDistSqr = currentDistSqr;
+    }
+  }
+  
+  return qSqrt(minDistSqr);
+}
+
 /*! \internal
   
   Finds the highest index of \a data, whose points y value is just below \a y. Assumes y values in
@@ -21897,6 +25508,7 @@ QCPCurve::~QCPCurve()
 void QCPCurve::setData(QSharedPointer<QCPCurveDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 
 /*! \overload
@@ -21914,6 +25526,7 @@ void QCPCurve::setData(const QVector<double> &t, const QVector<double> &keys, co
 {
   mDataContainer->clear();
   addData(t, keys, values, alreadySorted);
+  markDirty();
 }
 
 
@@ -21932,6 +25545,7 @@ void QCPCurve::setData(const QVector<double> &keys, const QVector<double> &value
 {
   mDataContainer->clear();
   addData(keys, values);
+  markDirty();
 }
 
 /*!
@@ -21944,6 +25558,7 @@ void QCPCurve::setData(const QVector<double> &keys, const QVector<double> &value
 void QCPCurve::setScatterStyle(const QCPScatterStyle &style)
 {
   mScatterStyle = style;
+  markDirty();
 }
 
 /*!
@@ -21960,6 +25575,7 @@ void QCPCurve::setScatterStyle(const QCPScatterStyle &style)
 void QCPCurve::setScatterSkip(int skip)
 {
   mScatterSkip = qMax(0, skip);
+  markDirty();
 }
 
 /*!
@@ -21972,6 +25588,7 @@ void QCPCurve::setScatterSkip(int skip)
 void QCPCurve::setLineStyle(QCPCurve::LineStyle style)
 {
   mLineStyle = style;
+  markDirty();
 }
 
 /*! \overload
@@ -22004,6 +25621,7 @@ void QCPCurve::addData(const QVector<double> &t, const QVector<double> &keys, co
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markDirty();
 }
 
 /*! \overload
@@ -22041,6 +25659,7 @@ void QCPCurve::addData(const QVector<double> &keys, const QVector<double> &value
     ++i;
   }
   mDataContainer->add(tempData, true); // don't modify tempData beyond this to prevent copy on write
+  markDirty();
 }
 
 /*! \overload
@@ -22052,6 +25671,7 @@ void QCPCurve::addData(const QVector<double> &keys, const QVector<double> &value
 void QCPCurve::addData(double t, double key, double value)
 {
   mDataContainer->add(QCPCurveData(t, key, value));
+  markDirty();
 }
 
 /*! \overload
@@ -22070,6 +25690,7 @@ void QCPCurve::addData(double key, double value)
     mDataContainer->add(QCPCurveData((mDataContainer->constEnd()-1)->t + 1.0, key, value));
   else
     mDataContainer->add(QCPCurveData(0.0, key, value));
+  markDirty();
 }
 
 /*!
@@ -23691,6 +27312,7 @@ QCPBars::~QCPBars()
 void QCPBars::setData(QSharedPointer<QCPBarsDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 
 /*! \overload
@@ -23708,6 +27330,7 @@ void QCPBars::setData(const QVector<double> &keys, const QVector<double> &values
 {
   mDataContainer->clear();
   addData(keys, values, alreadySorted);
+  markDirty();
 }
 
 /*!
@@ -23719,6 +27342,7 @@ void QCPBars::setData(const QVector<double> &keys, const QVector<double> &values
 void QCPBars::setWidth(double width)
 {
   mWidth = width;
+  markDirty();
 }
 
 /*!
@@ -23732,6 +27356,7 @@ void QCPBars::setWidth(double width)
 void QCPBars::setWidthType(QCPBars::WidthType widthType)
 {
   mWidthType = widthType;
+  markDirty();
 }
 
 /*!
@@ -23749,6 +27374,7 @@ void QCPBars::setBarsGroup(QCPBarsGroup *barsGroup)
   // register at new group:
   if (mBarsGroup)
     mBarsGroup->registerBars(this);
+  markDirty();
 }
 
 /*!
@@ -23766,6 +27392,7 @@ void QCPBars::setBarsGroup(QCPBarsGroup *barsGroup)
 void QCPBars::setBaseValue(double baseValue)
 {
   mBaseValue = baseValue;
+  markDirty();
 }
 
 /*!
@@ -23776,6 +27403,7 @@ void QCPBars::setBaseValue(double baseValue)
 void QCPBars::setStackingGap(double pixels)
 {
   mStackingGap = pixels;
+  markDirty();
 }
 
 /*! \overload
@@ -23807,6 +27435,7 @@ void QCPBars::addData(const QVector<double> &keys, const QVector<double> &values
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markDirty();
 }
 
 /*! \overload
@@ -23818,6 +27447,7 @@ void QCPBars::addData(const QVector<double> &keys, const QVector<double> &values
 void QCPBars::addData(double key, double value)
 {
   mDataContainer->add(QCPBarsData(key, value));
+  markDirty();
 }
 
 /*!
@@ -24567,6 +28197,7 @@ QCPStatisticalBox::QCPStatisticalBox(QCPAxis *keyAxis, QCPAxis *valueAxis) :
 void QCPStatisticalBox::setData(QSharedPointer<QCPStatisticalBoxDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 /*! \overload
   
@@ -24583,6 +28214,7 @@ void QCPStatisticalBox::setData(const QVector<double> &keys, const QVector<doubl
 {
   mDataContainer->clear();
   addData(keys, minimum, lowerQuartile, median, upperQuartile, maximum, alreadySorted);
+  markDirty();
 }
 
 /*!
@@ -24593,6 +28225,7 @@ void QCPStatisticalBox::setData(const QVector<double> &keys, const QVector<doubl
 void QCPStatisticalBox::setWidth(double width)
 {
   mWidth = width;
+  markDirty();
 }
 
 /*!
@@ -24606,6 +28239,7 @@ void QCPStatisticalBox::setWidth(double width)
 void QCPStatisticalBox::setWhiskerWidth(double width)
 {
   mWhiskerWidth = width;
+  markDirty();
 }
 
 /*!
@@ -24622,6 +28256,7 @@ void QCPStatisticalBox::setWhiskerWidth(double width)
 void QCPStatisticalBox::setWhiskerPen(const QPen &pen)
 {
   mWhiskerPen = pen;
+  markDirty();
 }
 
 /*!
@@ -24636,6 +28271,7 @@ void QCPStatisticalBox::setWhiskerPen(const QPen &pen)
 void QCPStatisticalBox::setWhiskerBarPen(const QPen &pen)
 {
   mWhiskerBarPen = pen;
+  markDirty();
 }
 
 /*!
@@ -24647,6 +28283,7 @@ void QCPStatisticalBox::setWhiskerBarPen(const QPen &pen)
 void QCPStatisticalBox::setWhiskerAntialiased(bool enabled)
 {
   mWhiskerAntialiased = enabled;
+  markDirty();
 }
 
 /*!
@@ -24655,6 +28292,7 @@ void QCPStatisticalBox::setWhiskerAntialiased(bool enabled)
 void QCPStatisticalBox::setMedianPen(const QPen &pen)
 {
   mMedianPen = pen;
+  markDirty();
 }
 
 /*!
@@ -24666,6 +28304,7 @@ void QCPStatisticalBox::setMedianPen(const QPen &pen)
 void QCPStatisticalBox::setOutlierStyle(const QCPScatterStyle &style)
 {
   mOutlierStyle = style;
+  markDirty();
 }
 
 /*! \overload
@@ -24703,6 +28342,7 @@ void QCPStatisticalBox::addData(const QVector<double> &keys, const QVector<doubl
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markDirty();
 }
 
 /*! \overload
@@ -24716,6 +28356,7 @@ void QCPStatisticalBox::addData(const QVector<double> &keys, const QVector<doubl
 void QCPStatisticalBox::addData(double key, double minimum, double lowerQuartile, double median, double upperQuartile, double maximum, const QVector<double> &outliers)
 {
   mDataContainer->add(QCPStatisticalBoxData(key, minimum, lowerQuartile, median, upperQuartile, maximum, outliers));
+  markDirty();
 }
 
 /*!
@@ -25690,6 +29331,7 @@ void QCPColorMap::setData(QCPColorMapData *data, bool copy)
     mMapData = data;
   }
   mMapImageInvalidated = true;
+  markDirty();
 }
 
 /*!
@@ -25710,6 +29352,7 @@ void QCPColorMap::setDataRange(const QCPRange &dataRange)
     else
       mDataRange = dataRange.sanitizedForLinScale();
     mMapImageInvalidated = true;
+    markDirty();
     emit dataRangeChanged(mDataRange);
   }
 }
@@ -25725,6 +29368,7 @@ void QCPColorMap::setDataScaleType(QCPAxis::ScaleType scaleType)
   {
     mDataScaleType = scaleType;
     mMapImageInvalidated = true;
+    markDirty();
     emit dataScaleTypeChanged(mDataScaleType);
     if (mDataScaleType == QCPAxis::stLogarithmic)
       setDataRange(mDataRange.sanitizedForLogScale());
@@ -25748,6 +29392,7 @@ void QCPColorMap::setGradient(const QCPColorGradient &gradient)
   {
     mGradient = gradient;
     mMapImageInvalidated = true;
+    markDirty();
     emit gradientChanged(mGradient);
   }
 }
@@ -25762,6 +29407,7 @@ void QCPColorMap::setInterpolate(bool enabled)
 {
   mInterpolate = enabled;
   mMapImageInvalidated = true; // because oversampling factors might need to change
+  markDirty();
 }
 
 /*!
@@ -25778,6 +29424,7 @@ void QCPColorMap::setInterpolate(bool enabled)
 void QCPColorMap::setTightBoundary(bool enabled)
 {
   mTightBoundary = enabled;
+  markDirty();
 }
 
 /*!
@@ -25818,6 +29465,7 @@ void QCPColorMap::setColorScale(QCPColorScale *colorScale)
     connect(mColorScale.data(), SIGNAL(gradientChanged(QCPColorGradient)), this, SLOT(setGradient(QCPColorGradient)));
     connect(mColorScale.data(), SIGNAL(dataScaleTypeChanged(QCPAxis::ScaleType)), this, SLOT(setDataScaleType(QCPAxis::ScaleType)));
   }
+  markDirty();
 }
 
 /*!
@@ -26344,6 +29992,7 @@ QCPFinancial::~QCPFinancial()
 void QCPFinancial::setData(QSharedPointer<QCPFinancialDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 
 /*! \overload
@@ -26361,6 +30010,7 @@ void QCPFinancial::setData(const QVector<double> &keys, const QVector<double> &o
 {
   mDataContainer->clear();
   addData(keys, open, high, low, close, alreadySorted);
+  markDirty();
 }
 
 /*!
@@ -26369,6 +30019,7 @@ void QCPFinancial::setData(const QVector<double> &keys, const QVector<double> &o
 void QCPFinancial::setChartStyle(QCPFinancial::ChartStyle style)
 {
   mChartStyle = style;
+  markDirty();
 }
 
 /*!
@@ -26379,6 +30030,7 @@ void QCPFinancial::setChartStyle(QCPFinancial::ChartStyle style)
 void QCPFinancial::setWidth(double width)
 {
   mWidth = width;
+  markDirty();
 }
 
 /*!
@@ -26392,6 +30044,7 @@ void QCPFinancial::setWidth(double width)
 void QCPFinancial::setWidthType(QCPFinancial::WidthType widthType)
 {
   mWidthType = widthType;
+  markDirty();
 }
 
 /*!
@@ -26406,6 +30059,7 @@ void QCPFinancial::setWidthType(QCPFinancial::WidthType widthType)
 void QCPFinancial::setTwoColored(bool twoColored)
 {
   mTwoColored = twoColored;
+  markDirty();
 }
 
 /*!
@@ -26420,6 +30074,7 @@ void QCPFinancial::setTwoColored(bool twoColored)
 void QCPFinancial::setBrushPositive(const QBrush &brush)
 {
   mBrushPositive = brush;
+  markDirty();
 }
 
 /*!
@@ -26434,6 +30089,7 @@ void QCPFinancial::setBrushPositive(const QBrush &brush)
 void QCPFinancial::setBrushNegative(const QBrush &brush)
 {
   mBrushNegative = brush;
+  markDirty();
 }
 
 /*!
@@ -26448,6 +30104,7 @@ void QCPFinancial::setBrushNegative(const QBrush &brush)
 void QCPFinancial::setPenPositive(const QPen &pen)
 {
   mPenPositive = pen;
+  markDirty();
 }
 
 /*!
@@ -26462,6 +30119,7 @@ void QCPFinancial::setPenPositive(const QPen &pen)
 void QCPFinancial::setPenNegative(const QPen &pen)
 {
   mPenNegative = pen;
+  markDirty();
 }
 
 /*! \overload
@@ -26498,6 +30156,7 @@ void QCPFinancial::addData(const QVector<double> &keys, const QVector<double> &o
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markDirty();
 }
 
 /*! \overload
@@ -26513,6 +30172,7 @@ void QCPFinancial::addData(const QVector<double> &keys, const QVector<double> &o
 void QCPFinancial::addData(double key, double open, double high, double low, double close)
 {
   mDataContainer->add(QCPFinancialData(key, open, high, low, close));
+  markDirty();
 }
 
 /*!
@@ -27238,6 +30898,7 @@ QCPErrorBars::~QCPErrorBars()
 void QCPErrorBars::setData(QSharedPointer<QCPErrorBarsDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 
 /*! \overload
@@ -27253,6 +30914,7 @@ void QCPErrorBars::setData(const QVector<double> &error)
 {
   mDataContainer->clear();
   addData(error);
+  markDirty();
 }
 
 /*! \overload
@@ -27269,6 +30931,7 @@ void QCPErrorBars::setData(const QVector<double> &errorMinus, const QVector<doub
 {
   mDataContainer->clear();
   addData(errorMinus, errorPlus);
+  markDirty();
 }
 
 /*!
@@ -27287,6 +30950,7 @@ void QCPErrorBars::setData(const QVector<double> &errorMinus, const QVector<doub
 */
 void QCPErrorBars::setDataPlottable(QCPAbstractPlottable *plottable)
 {
+  markDirty();
   if (plottable && qobject_cast<QCPErrorBars*>(plottable))
   {
     mDataPlottable = 0;
@@ -27310,6 +30974,7 @@ void QCPErrorBars::setDataPlottable(QCPAbstractPlottable *plottable)
 void QCPErrorBars::setErrorType(ErrorType type)
 {
   mErrorType = type;
+  markDirty();
 }
 
 /*!
@@ -27319,6 +30984,7 @@ void QCPErrorBars::setErrorType(ErrorType type)
 void QCPErrorBars::setWhiskerWidth(double pixels)
 {
   mWhiskerWidth = pixels;
+  markDirty();
 }
 
 /*!
@@ -27329,6 +30995,7 @@ void QCPErrorBars::setWhiskerWidth(double pixels)
 void QCPErrorBars::setSymbolGap(double pixels)
 {
   mSymbolGap = pixels;
+  markDirty();
 }
 
 /*! \overload
@@ -27363,6 +31030,7 @@ void QCPErrorBars::addData(const QVector<double> &errorMinus, const QVector<doub
   mDataContainer->reserve(n);
   for (int i=0; i<n; ++i)
     mDataContainer->append(QCPErrorBarsData(errorMinus.at(i), errorPlus.at(i)));
+  markDirty();
 }
 
 /*! \overload
@@ -27377,6 +31045,7 @@ void QCPErrorBars::addData(const QVector<double> &errorMinus, const QVector<doub
 void QCPErrorBars::addData(double error)
 {
   mDataContainer->append(QCPErrorBarsData(error));
+  markDirty();
 }
 
 /*! \overload
@@ -27392,6 +31061,7 @@ void QCPErrorBars::addData(double error)
 void QCPErrorBars::addData(double errorMinus, double errorPlus)
 {
   mDataContainer->append(QCPErrorBarsData(errorMinus, errorPlus));
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -28107,6 +31777,7 @@ QCPItemStraightLine::~QCPItemStraightLine()
 void QCPItemStraightLine::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28117,6 +31788,7 @@ void QCPItemStraightLine::setPen(const QPen &pen)
 void QCPItemStraightLine::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -28290,6 +31962,7 @@ QCPItemLine::~QCPItemLine()
 void QCPItemLine::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28300,6 +31973,7 @@ void QCPItemLine::setPen(const QPen &pen)
 void QCPItemLine::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28313,6 +31987,7 @@ void QCPItemLine::setSelectedPen(const QPen &pen)
 void QCPItemLine::setHead(const QCPLineEnding &head)
 {
   mHead = head;
+  markDirty();
 }
 
 /*!
@@ -28326,6 +32001,7 @@ void QCPItemLine::setHead(const QCPLineEnding &head)
 void QCPItemLine::setTail(const QCPLineEnding &tail)
 {
   mTail = tail;
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -28532,6 +32208,7 @@ QCPItemCurve::~QCPItemCurve()
 void QCPItemCurve::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28542,6 +32219,7 @@ void QCPItemCurve::setPen(const QPen &pen)
 void QCPItemCurve::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28555,6 +32233,7 @@ void QCPItemCurve::setSelectedPen(const QPen &pen)
 void QCPItemCurve::setHead(const QCPLineEnding &head)
 {
   mHead = head;
+  markDirty();
 }
 
 /*!
@@ -28568,6 +32247,7 @@ void QCPItemCurve::setHead(const QCPLineEnding &head)
 void QCPItemCurve::setTail(const QCPLineEnding &tail)
 {
   mTail = tail;
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -28695,6 +32375,7 @@ QCPItemRect::~QCPItemRect()
 void QCPItemRect::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28705,6 +32386,7 @@ void QCPItemRect::setPen(const QPen &pen)
 void QCPItemRect::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28716,6 +32398,7 @@ void QCPItemRect::setSelectedPen(const QPen &pen)
 void QCPItemRect::setBrush(const QBrush &brush)
 {
   mBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -28727,6 +32410,7 @@ void QCPItemRect::setBrush(const QBrush &brush)
 void QCPItemRect::setSelectedBrush(const QBrush &brush)
 {
   mSelectedBrush = brush;
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -28862,6 +32546,7 @@ QCPItemText::~QCPItemText()
 void QCPItemText::setColor(const QColor &color)
 {
   mColor = color;
+  markDirty();
 }
 
 /*!
@@ -28870,6 +32555,7 @@ void QCPItemText::setColor(const QColor &color)
 void QCPItemText::setSelectedColor(const QColor &color)
 {
   mSelectedColor = color;
+  markDirty();
 }
 
 /*!
@@ -28881,6 +32567,7 @@ void QCPItemText::setSelectedColor(const QColor &color)
 void QCPItemText::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28892,6 +32579,7 @@ void QCPItemText::setPen(const QPen &pen)
 void QCPItemText::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /*!
@@ -28903,6 +32591,7 @@ void QCPItemText::setSelectedPen(const QPen &pen)
 void QCPItemText::setBrush(const QBrush &brush)
 {
   mBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -28914,6 +32603,7 @@ void QCPItemText::setBrush(const QBrush &brush)
 void QCPItemText::setSelectedBrush(const QBrush &brush)
 {
   mSelectedBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -28924,6 +32614,7 @@ void QCPItemText::setSelectedBrush(const QBrush &brush)
 void QCPItemText::setFont(const QFont &font)
 {
   mFont = font;
+  markDirty();
 }
 
 /*!
@@ -28934,6 +32625,7 @@ void QCPItemText::setFont(const QFont &font)
 void QCPItemText::setSelectedFont(const QFont &font)
 {
   mSelectedFont = font;
+  markDirty();
 }
 
 /*!
@@ -28945,6 +32637,7 @@ void QCPItemText::setSelectedFont(const QFont &font)
 void QCPItemText::setText(const QString &text)
 {
   mText = text;
+  markDirty();
 }
 
 /*!
@@ -28962,6 +32655,7 @@ void QCPItemText::setText(const QString &text)
 void QCPItemText::setPositionAlignment(Qt::Alignment alignment)
 {
   mPositionAlignment = alignment;
+  markDirty();
 }
 
 /*!
@@ -28970,6 +32664,7 @@ void QCPItemText::setPositionAlignment(Qt::Alignment alignment)
 void QCPItemText::setTextAlignment(Qt::Alignment alignment)
 {
   mTextAlignment = alignment;
+  markDirty();
 }
 
 /*!
@@ -28979,6 +32674,7 @@ void QCPItemText::setTextAlignment(Qt::Alignment alignment)
 void QCPItemText::setRotation(double degrees)
 {
   mRotation = degrees;
+  markDirty();
 }
 
 /*!
@@ -28988,6 +32684,7 @@ void QCPItemText::setRotation(double degrees)
 void QCPItemText::setPadding(const QMargins &padding)
 {
   mPadding = padding;
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -29203,6 +32900,7 @@ QCPItemEllipse::~QCPItemEllipse()
 void QCPItemEllipse::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -29213,6 +32911,7 @@ void QCPItemEllipse::setPen(const QPen &pen)
 void QCPItemEllipse::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /*!
@@ -29224,6 +32923,7 @@ void QCPItemEllipse::setSelectedPen(const QPen &pen)
 void QCPItemEllipse::setBrush(const QBrush &brush)
 {
   mBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -29235,6 +32935,7 @@ void QCPItemEllipse::setBrush(const QBrush &brush)
 void QCPItemEllipse::setSelectedBrush(const QBrush &brush)
 {
   mSelectedBrush = brush;
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -29397,6 +33098,7 @@ void QCPItemPixmap::setPixmap(const QPixmap &pixmap)
   mScaledPixmapInvalidated = true;
   if (mPixmap.isNull())
     qDebug() << Q_FUNC_INFO << "pixmap is null";
+  markDirty();
 }
 
 /*!
@@ -29409,6 +33111,7 @@ void QCPItemPixmap::setScaled(bool scaled, Qt::AspectRatioMode aspectRatioMode,
   mAspectRatioMode = aspectRatioMode;
   mTransformationMode = transformationMode;
   mScaledPixmapInvalidated = true;
+  markDirty();
 }
 
 /*!
@@ -29419,6 +33122,7 @@ void QCPItemPixmap::setScaled(bool scaled, Qt::AspectRatioMode aspectRatioMode,
 void QCPItemPixmap::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -29429,6 +33133,7 @@ void QCPItemPixmap::setPen(const QPen &pen)
 void QCPItemPixmap::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -29677,6 +33382,7 @@ QCPItemTracer::~QCPItemTracer()
 void QCPItemTracer::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -29687,6 +33393,7 @@ void QCPItemTracer::setPen(const QPen &pen)
 void QCPItemTracer::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /*!
@@ -29697,6 +33404,7 @@ void QCPItemTracer::setSelectedPen(const QPen &pen)
 void QCPItemTracer::setBrush(const QBrush &brush)
 {
   mBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -29707,6 +33415,7 @@ void QCPItemTracer::setBrush(const QBrush &brush)
 void QCPItemTracer::setSelectedBrush(const QBrush &brush)
 {
   mSelectedBrush = brush;
+  markDirty();
 }
 
 /*!
@@ -29716,6 +33425,7 @@ void QCPItemTracer::setSelectedBrush(const QBrush &brush)
 void QCPItemTracer::setSize(double size)
 {
   mSize = size;
+  markDirty();
 }
 
 /*!
@@ -29727,6 +33437,7 @@ void QCPItemTracer::setSize(double size)
 void QCPItemTracer::setStyle(QCPItemTracer::TracerStyle style)
 {
   mStyle = style;
+  markDirty();
 }
 
 /*!
@@ -29755,6 +33466,7 @@ void QCPItemTracer::setGraph(QCPGraph *graph)
   {
     mGraph = 0;
   }
+  markDirty();
 }
 
 /*!
@@ -29769,6 +33481,7 @@ void QCPItemTracer::setGraph(QCPGraph *graph)
 void QCPItemTracer::setGraphKey(double key)
 {
   mGraphKey = key;
+  markDirty();
 }
 
 /*!
@@ -29785,6 +33498,7 @@ void QCPItemTracer::setGraphKey(double key)
 void QCPItemTracer::setInterpolating(bool enabled)
 {
   mInterpolating = enabled;
+  markDirty();
 }
 
 /* inherits documentation from base class */
@@ -29909,43 +33623,46 @@ void QCPItemTracer::updatePosition()
   {
     if (mParentPlot->hasPlottable(mGraph))
     {
-      if (mGraph->data()->size() > 1)
+      // access the data via the 1D interface, so both the data container and column data of the graph are supported:
+      const int dataCount = mGraph->dataCount();
+      if (dataCount > 1)
       {
-        QCPGraphDataContainer::const_iterator first = mGraph->data()->constBegin();
-        QCPGraphDataContainer::const_iterator last = mGraph->data()->constEnd()-1;
-        if (mGraphKey <= first->key)
-          position->setCoords(first->key, first->value);
-        else if (mGraphKey >= last->key)
-          position->setCoords(last->key, last->value);
+        const int last = dataCount-1;
+        if (mGraphKey <= mGraph->dataMainKey(0))
+          position->setCoords(mGraph->dataMainKey(0), mGraph->dataMainValue(0));
+        else if (mGraphKey >= mGraph->dataMainKey(last))
+          position->setCoords(mGraph->dataMainKey(last), mGraph->dataMainValue(last));
         else
         {
-          QCPGraphDataContainer::const_iterator it = mGraph->data()->findBegin(mGraphKey);
-          if (it != mGraph->data()->constEnd()) // mGraphKey is not exactly on last iterator, but somewhere between iterators
+          int index = mGraph->findBegin(mGraphKey);
+          if (index < last) // mGraphKey is not exactly on last data point, but somewhere between data points
           {
-            QCPGraphDataContainer::const_iterator prevIt = it;
-            ++it; // won't advance to constEnd because we handled that case (mGraphKey >= last->key) before
+            const double prevKey = mGraph->dataMainKey(index);
+            const double prevValue = mGraph->dataMainValue(index);
+            ++index; // won't advance beyond last because we handled that case (mGraphKey >= last key) before
+            const double key = mGraph->dataMainKey(index);
+            const double value = mGraph->dataMainValue(index);
             if (mInterpolating)
             {
-              // interpolate between iterators around mGraphKey:
+              // interpolate between data points around mGraphKey:
               double slope = 0;
-              if (!qFuzzyCompare((double)it->key, (double)prevIt->key))
-                slope = (it->value-prevIt->value)/(it->key-prevIt->key);
-              position->setCoords(mGraphKey, (mGraphKey-prevIt->key)*slope+prevIt->value);
+              if (!qFuzzyCompare(key, prevKey))
+                slope = (value-prevValue)/(key-prevKey);
+              position->setCoords(mGraphKey, (mGraphKey-prevKey)*slope+prevValue);
             } else
             {
-              // find iterator with key closest to mGraphKey:
-              if (mGraphKey < (prevIt->key+it->key)*0.5)
-                position->setCoords(prevIt->key, prevIt->value);
+              // find data point with key closest to mGraphKey:
+              if (mGraphKey < (prevKey+key)*0.5)
+                position->setCoords(prevKey, prevValue);
               else
-                position->setCoords(it->key, it->value);
+                position->setCoords(key, value);
             }
-          } else // mGraphKey is exactly on last iterator (should actually be caught when comparing first/last keys, but this is a failsafe for fp uncertainty)
-            position->setCoords(it->key, it->value);
+          } else // mGraphKey is exactly on last data point (should actually be caught when comparing first/last keys, but this is a failsafe for fp uncertainty)
+            position->setCoords(mGraph->dataMainKey(last), mGraph->dataMainValue(last));
         }
-      } else if (mGraph->data()->size() == 1)
+      } else if (dataCount == 1)
       {
-        QCPGraphDataContainer::const_iterator it = mGraph->data()->constBegin();
-        position->setCoords(it->key, it->value);
+        position->setCoords(mGraph->dataMainKey(0), mGraph->dataMainValue(0));
       } else
         qDebug() << Q_FUNC_INFO << "graph has no data";
     } else
@@ -30039,6 +33756,7 @@ QCPItemBracket::~QCPItemBracket()
 void QCPItemBracket::setPen(const QPen &pen)
 {
   mPen = pen;
+  markDirty();
 }
 
 /*!
@@ -30049,6 +33767,7 @@ void QCPItemBracket::setPen(const QPen &pen)
 void QCPItemBracket::setSelectedPen(const QPen &pen)
 {
   mSelectedPen = pen;
+  markDirty();
 }
 
 /*!
@@ -30062,6 +33781,7 @@ void QCPItemBracket::setSelectedPen(const QPen &pen)
 void QCPItemBracket::setLength(double length)
 {
   mLength = length;
+  markDirty();
 }
 
 /*!
@@ -30072,6 +33792,7 @@ void QCPItemBracket::setLength(double length)
 void QCPItemBracket::setStyle(QCPItemBracket::BracketStyle style)
 {
   mStyle = style;
+  markDirty();
 }
 
 /* inherits documentation from base class */
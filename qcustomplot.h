@@ -51,11 +51,17 @@
 #include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
 #include <QtGui/QPainter>
 #include <QtGui/QPaintEvent>
 #include <QtGui/QMouseEvent>
 #include <QtGui/QWheelEvent>
 #include <QtGui/QPixmap>
+#include <QtGui/QImage>
+#include <QtGui/QPicture>
 #include <QtCore/QVector>
 #include <QtCore/QString>
 #include <QtCore/QDateTime>
@@ -65,6 +71,8 @@
 #include <QtCore/QStack>
 #include <QtCore/QCache>
 #include <QtCore/QMargins>
+#include <QtCore/QFile>
+#include <QtCore/QAtomicInt>
 #include <qmath.h>
 #include <limits>
 #include <algorithm>
@@ -243,6 +251,16 @@ enum PlottingHint { phNone              = 0x000 ///< <tt>0x000</tt> No hints are
                     ,phImmediateRefresh = 0x002 ///< <tt>0x002</tt> causes an immediate repaint() instead of a soft update() when QCustomPlot::replot() is called with parameter \ref QCustomPlot::rpRefreshHint.
                                                 ///<                This is set by default to prevent the plot from freezing on fast consecutive replots (e.g. user drags ranges with mouse).
                     ,phCacheLabels      = 0x004 ///< <tt>0x004</tt> axis (tick) labels will be cached as pixmaps, increasing replot performance.
+                    ,phSkipCleanLayers  = 0x008 ///< <tt>0x008</tt> QCustomPlot::replot() only redraws paint buffers whose layers were changed since the last replot (see \ref QCPLayer::markDirty).
+                                                ///<                The other buffers keep their content and are only composited again.
+                    ,phParallelLayers   = 0x010 ///< <tt>0x010</tt> QCustomPlot::replot() rasterizes the paint buffers of different buffered layers concurrently on a thread pool (see \ref QCPLayer::lmBuffered).
+                                                ///<                Without this hint, the layers are drawn serially, which may be useful for debugging.
+                    ,phParallelAxisRects = 0x020 ///< <tt>0x020</tt> QCustomPlot::replot() rasterizes the content of each axis rect (e.g. its plottables) into a separate image on a thread pool, which is then blitted into the layer's paint buffer.
+                                                ///<                This scales with the number of axis rects even if their plottables share a layer. Axis rects must not overlap.
+                    ,phSkipUnchangedLayout = 0x040 ///< <tt>0x040</tt> QCustomPlot::replot() skips the margin and layout phases of the layout system if nothing that affects the layout changed since the previous replot,
+                                                ///<                e.g. when only a value axis is panned without changing its tick label extents (see QCustomPlot::updateLayout).
+                    ,phParallelSampling = 0x080 ///< <tt>0x080</tt> QCPGraph performs the adaptive sampling of large data sets concurrently in pixel-aligned chunks on the render thread pool of QCustomPlot.
+                                                ///<                The sampled lines are identical to the serial algorithm (see QCPGraph::setAdaptiveSampling).
                   };
 Q_DECLARE_FLAGS(PlottingHints, PlottingHint)
 
@@ -537,18 +555,32 @@ public:
   virtual QCPPainter *startPainting() = 0;
   virtual void donePainting() {}
   virtual void draw(QCPPainter *painter) const = 0;
+  virtual void drawPart(QCPPainter *painter, const QRect &rect) const;
   virtual void clear(const QColor &color) = 0;
+  virtual void setImage(const QImage &image);
   
 protected:
+  enum { spareImageCount = 4 };
+  
   // property members:
   QSize mSize;
   double mDevicePixelRatio;
   
   // non-property members:
   bool mInvalidated;
+  QList<QImage> mSpareImages;
   
   // introduced virtual methods:
   virtual void reallocateBuffer() = 0;
+  
+  // non-virtual methods:
+  QImage takeSpareImage(const QSize &pixelSize);
+  void recycleImage(const QImage &image);
+  
+  // static methods:
+  static QSize allocationSize(const QSize &allocatedSize, const QSize &requiredSize);
+  
+  friend class QCPPaintBufferRenderTask;
 };
 
 
@@ -561,6 +593,7 @@ public:
   // reimplemented virtual methods:
   virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
   virtual void draw(QCPPainter *painter) const Q_DECL_OVERRIDE;
+  virtual void drawPart(QCPPainter *painter, const QRect &rect) const Q_DECL_OVERRIDE;
   void clear(const QColor &color) Q_DECL_OVERRIDE;
   
 protected:
@@ -572,6 +605,74 @@ protected:
 };
 
 
+class QCP_LIB_DECL QCPPaintBufferImage : public QCPAbstractPaintBuffer
+{
+public:
+  explicit QCPPaintBufferImage(const QSize &size, double devicePixelRatio);
+  virtual ~QCPPaintBufferImage();
+  
+  // getters:
+  QImage image() const;
+  
+  // reimplemented virtual methods:
+  virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
+  virtual void draw(QCPPainter *painter) const Q_DECL_OVERRIDE;
+  virtual void drawPart(QCPPainter *painter, const QRect &rect) const Q_DECL_OVERRIDE;
+  void clear(const QColor &color) Q_DECL_OVERRIDE;
+  virtual void setImage(const QImage &image) Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QImage mBuffer;
+  
+  // reimplemented virtual methods:
+  virtual void reallocateBuffer() Q_DECL_OVERRIDE;
+};
+
+
+class QCP_LIB_DECL QCPPaintBufferRenderTask : public QRunnable
+{
+public:
+  explicit QCPPaintBufferRenderTask(QObject *receiver=0, const char *member=0);
+  
+  // getters:
+  bool isEmpty() const { return mJobs.isEmpty(); }
+  
+  // non-property methods:
+  void addPicture(const QSharedPointer<QCPAbstractPaintBuffer> &buffer, const QPicture &picture, const QRect &rect);
+  void removePictures(const QSharedPointer<QCPAbstractPaintBuffer> &buffer);
+  void applyImages();
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+  // static methods:
+  static void applyImages(const QList<QSharedPointer<QCPPaintBufferRenderTask> > &tasks);
+  
+protected:
+  struct BufferJob
+  {
+    QSharedPointer<QCPAbstractPaintBuffer> buffer;
+    QPicture picture;
+    QRect rect;
+    QSize size;
+    double devicePixelRatio;
+    QImage image;
+  };
+  
+  // non-property members:
+  QObject *mReceiver;
+  QByteArray mMember;
+  QList<BufferJob> mJobs;
+  
+  // non-virtual methods:
+  void releaseImages();
+  
+  // static methods:
+  static void applyJobs(const QList<BufferJob> &jobs);
+};
+
+
 #ifdef QCP_OPENGL_PBUFFER
 class QCP_LIB_DECL QCPPaintBufferGlPbuffer : public QCPAbstractPaintBuffer
 {
@@ -660,6 +761,7 @@ public:
   QList<QCPLayerable*> children() const { return mChildren; }
   bool visible() const { return mVisible; }
   LayerMode mode() const { return mMode; }
+  bool dirty() const { return mDirty; }
   
   // setters:
   void setVisible(bool visible);
@@ -667,6 +769,8 @@ public:
   
   // non-virtual methods:
   void replot();
+  void markDirty() { mDirty = true; mDirtyRegion = QRegion(); }
+  void markDirty(const QRect &rect);
   
 protected:
   // property members:
@@ -679,13 +783,20 @@ protected:
   
   // non-property members:
   QWeakPointer<QCPAbstractPaintBuffer> mPaintBuffer;
+  bool mDirty;
+  QRegion mDirtyRegion;
   
   // non-virtual methods:
+  QRegion dirtyRegion() const;
+  void markClean() { mDirty = false; mDirtyRegion = QRegion(); }
   void draw(QCPPainter *painter);
   void drawToPaintBuffer();
   void addChild(QCPLayerable *layerable, bool prepend);
   void removeChild(QCPLayerable *layerable);
   
+  // static methods:
+  static void drawLayerable(QCPPainter *painter, QCPLayerable *layerable);
+  
 private:
   Q_DISABLE_COPY(QCPLayer)
   
@@ -723,6 +834,7 @@ public:
   
   // introduced virtual methods:
   virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=0) const;
+  virtual void markDirty();
 
   // non-property methods:
   bool realVisibility() const;
@@ -2421,9 +2533,14 @@ public:
   int size() const { return mData.size()-mPreallocSize; }
   bool isEmpty() const { return size() == 0; }
   bool autoSqueeze() const { return mAutoSqueeze; }
+  bool valueRangeIndex() const { return mValueRangeIndex; }
+  int fixedCapacity() const { return mFixedCapacity; }
+  uint revision() const { return mRevision; }
   
   // setters:
   void setAutoSqueeze(bool enabled);
+  void setValueRangeIndex(bool enabled);
+  void setFixedCapacity(int capacity);
   
   // non-virtual methods:
   void set(const QCPDataContainer<DataType> &data);
@@ -2441,28 +2558,56 @@ public:
   
   const_iterator constBegin() const { return mData.constBegin()+mPreallocSize; }
   const_iterator constEnd() const { return mData.constEnd(); }
-  iterator begin() { return mData.begin()+mPreallocSize; }
-  iterator end() { return mData.end(); }
+  iterator begin() { invalidateIndex(); ++mRevision; return mData.begin()+mPreallocSize; }
+  iterator end() { invalidateIndex(); ++mRevision; return mData.end(); }
   const_iterator findBegin(double sortKey, bool expandedRange=true) const;
   const_iterator findEnd(double sortKey, bool expandedRange=true) const;
   const_iterator at(int index) const { return constBegin()+qBound(0, index, size()); }
   QCPRange keyRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth);
   QCPRange valueRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange());
+  QCPRange valueRange(bool &foundRange, const_iterator begin, const_iterator end, QCP::SignDomain signDomain=QCP::sdBoth) const;
   QCPDataRange dataRange() const { return QCPDataRange(0, size()); }
   void limitIteratorsToDataRange(const_iterator &begin, const_iterator &end, const QCPDataRange &dataRange) const;
   
 protected:
+  /*!
+    Summarizes the value ranges of a contiguous block of data points, see \ref setValueRangeIndex.
+    Members are NaN if no data point of the block contributes to them.
+  */
+  struct IndexNode
+  {
+    double lower, upper;   ///< smallest lower and largest upper bound of the data point value ranges
+    double lowerPositive;  ///< smallest lower bound that is greater than zero
+    double upperNegative;  ///< largest upper bound that is smaller than zero
+  };
+  enum { indexBlockSize = 64 ///< number of data points summarized by one node of the lowest index level
+         ,indexFanout = 8    ///< number of nodes summarized by one node of the next higher index level
+       };
+  
   // property members:
   bool mAutoSqueeze;
+  bool mValueRangeIndex;
+  int mFixedCapacity;
   
   // non-property memebers:
   QVector<DataType> mData;
   int mPreallocSize;
   int mPreallocIteration;
+  mutable QVector<QVector<IndexNode> > mIndexLevels;
+  mutable int mIndexedSize;
+  uint mRevision;
   
   // non-virtual methods:
   void preallocateGrow(int minimumPreallocSize);
   void performAutoSqueeze();
+  void prepareFixedCapacityAppend(int appendCount, bool dropOldest);
+  void enforceFixedCapacity();
+  void invalidateIndex(int fromStorageIndex=0) { mIndexedSize = qMin(mIndexedSize, fromStorageIndex); }
+  void updateIndex() const;
+  IndexNode summarizeValueRange(int storageBegin, int storageEnd) const;
+  static IndexNode emptyIndexNode();
+  static void expandIndexNode(IndexNode &node, const QCPRange &range);
+  static void expandIndexNode(IndexNode &node, const IndexNode &other);
 };
 
 // include implementation in header since it is a class template:
@@ -2503,6 +2648,14 @@ protected:
   sort. Failing to do so can not be detected by the container efficiently and will cause both
   rendering artifacts and potential data loss.
 
+  For large data sets, the container can maintain an index of the data point value ranges (see
+  \ref setValueRangeIndex), which allows \ref valueRange to be determined in logarithmic instead of
+  linear time.
+
+  For rolling real-time windows, where new data is appended and old data is removed continuously,
+  the container can be limited to a fixed number of data points (see \ref setFixedCapacity). It
+  then works on a storage that is allocated once, and drops the oldest data points automatically.
+
   Implementing one-dimensional plottables that make use of a \ref QCPDataContainer<T> is usually
   done by subclassing from \ref QCPAbstractPlottable1D "QCPAbstractPlottable1D<T>", which
   introduces an according \a mDataContainer member and some convenience methods.
@@ -2570,6 +2723,9 @@ protected:
   You can manipulate the data points in-place through the non-const iterators, but great care must
   be taken when manipulating the sort key of a data point, see \ref sort, or the detailed
   description of this class.
+
+  Since the data may be changed through the returned iterator, calling this method invalidates the
+  value range index (see \ref setValueRangeIndex) and increases the \ref revision.
 */
 
 /*! \fn QCPDataContainer::iterator QCPDataContainer<DataType>::end() const
@@ -2579,6 +2735,17 @@ protected:
   You can manipulate the data points in-place through the non-const iterators, but great care must
   be taken when manipulating the sort key of a data point, see \ref sort, or the detailed
   description of this class.
+
+  Since the data may be changed through the returned iterator, calling this method invalidates the
+  value range index (see \ref setValueRangeIndex) and increases the \ref revision.
+*/
+
+/*! \fn uint QCPDataContainer<DataType>::revision() const
+  
+  Returns a number that changes whenever the data of this container may have changed, i.e. with
+  every call of a modifying method like \ref add or \ref remove, and every call of the non-const
+  iterators \ref begin and \ref end. Plottables use it to detect whether results they derived from
+  the data, e.g. the sampled line of a QCPGraph, are still up to date.
 */
 
 /*! \fn QCPDataContainer::const_iterator QCPDataContainer<DataType>::at(int index) const
@@ -2606,8 +2773,12 @@ protected:
 template <class DataType>
 QCPDataContainer<DataType>::QCPDataContainer() :
   mAutoSqueeze(true),
+  mValueRangeIndex(true),
+  mFixedCapacity(0),
   mPreallocSize(0),
-  mPreallocIteration(0)
+  mPreallocIteration(0),
+  mIndexedSize(0),
+  mRevision(0)
 {
 }
 
@@ -2630,6 +2801,75 @@ void QCPDataContainer<DataType>::setAutoSqueeze(bool enabled)
   }
 }
 
+/*!
+  Limits the number of data points in this container to \a capacity. This is useful for rolling
+  real-time windows, where new data is appended on every update and old data is no longer needed.
+
+  When adding data points would exceed the capacity, the data points with the smallest (sort-)keys
+  are dropped, so the container always holds the most recent \a capacity data points.
+
+  In this mode, the container allocates storage for twice the capacity once. Appending data points
+  (with respect to the sort key) and removing data points from the front (e.g. with \ref
+  removeBefore or by exceeding the capacity) then never cause reallocations: Dropping points from
+  the front just advances the begin of the data, and when appended data reaches the end of the
+  storage, the remaining data points are moved back to the beginning. Since this happens at most
+  once every \a capacity appended data points, appending has constant amortized cost. The data
+  stays contiguous, so iterators, \ref findBegin, \ref findEnd and plottables using the container
+  work as usual. Automatic squeezing (\ref setAutoSqueeze) is suspended in this mode.
+
+  Prepending data points, inserting them between existing keys, or adding more than \a capacity
+  data points at once is still supported, but may cause reallocations.
+
+  Set \a capacity to 0 to disable the fixed capacity mode, which is the default.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::setFixedCapacity(int capacity)
+{
+  capacity = qMax(0, capacity);
+  if (mFixedCapacity == capacity)
+    return;
+  
+  mFixedCapacity = capacity;
+  if (mFixedCapacity > 0)
+  {
+    enforceFixedCapacity();
+    squeeze(true, false); // move remaining data to the front of the storage
+    mData.reserve(2*mFixedCapacity);
+  } else if (mAutoSqueeze)
+    performAutoSqueeze();
+}
+
+/*!
+  Sets whether the container maintains an index of the value ranges of its data points. The index
+  allows \ref valueRange to find the value range of large data sets (e.g. when rescaling value axes
+  to the data in a certain key range) in logarithmic time, instead of iterating over every data
+  point in the requested key range.
+
+  The index summarizes blocks of data points in a hierarchy of minimum/maximum values. It is built
+  lazily, i.e. only when a value range of a sufficiently large number of data points is requested.
+  Data that is appended (with respect to the sort key) only causes the last blocks of the index to
+  be updated on the next request, so streaming data into the container stays cheap. Removing data
+  from the front with \ref removeBefore doesn't affect the index at all. Other modifications, like
+  prepending or inserting data points or accessing the data via the non-const iterators \ref begin
+  and \ref end, cause the affected part of the index to be rebuilt on the next request.
+
+  By default the index is enabled. It requires roughly 0.6 bytes of additional memory per data
+  point once it is built. Disabling it releases that memory.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::setValueRangeIndex(bool enabled)
+{
+  if (mValueRangeIndex != enabled)
+  {
+    mValueRangeIndex = enabled;
+    if (!mValueRangeIndex)
+    {
+      mIndexLevels.clear();
+      mIndexedSize = 0;
+    }
+  }
+}
+
 /*! \overload
   
   Replaces the current data in this container with the provided \a data.
@@ -2655,11 +2895,19 @@ void QCPDataContainer<DataType>::set(const QCPDataContainer<DataType> &data)
 template <class DataType>
 void QCPDataContainer<DataType>::set(const QVector<DataType> &data, bool alreadySorted)
 {
-  mData = data;
+  ++mRevision;
+  if (mFixedCapacity > 0) // keep the storage that was reserved for the fixed capacity, instead of sharing the storage of data
+  {
+    mData.resize(data.size());
+    std::copy(data.constBegin(), data.constEnd(), mData.begin());
+  } else
+    mData = data;
   mPreallocSize = 0;
   mPreallocIteration = 0;
+  invalidateIndex();
   if (!alreadySorted)
     sort();
+  enforceFixedCapacity();
 }
 
 /*! \overload
@@ -2671,6 +2919,7 @@ void QCPDataContainer<DataType>::set(const QVector<DataType> &data, bool already
 template <class DataType>
 void QCPDataContainer<DataType>::add(const QCPDataContainer<DataType> &data)
 {
+  ++mRevision;
   if (data.isEmpty())
     return;
   
@@ -2685,11 +2934,14 @@ void QCPDataContainer<DataType>::add(const QCPDataContainer<DataType> &data)
     std::copy(data.constBegin(), data.constEnd(), begin());
   } else // don't need to prepend, so append and merge if necessary
   {
+    if (mFixedCapacity > 0)
+      prepareFixedCapacityAppend(n, oldSize == 0 || !qcpLessThanSortKey<DataType>(*data.constBegin(), *(constEnd()-1)));
     mData.resize(mData.size()+n);
-    std::copy(data.constBegin(), data.constEnd(), end()-n);
-    if (oldSize > 0 && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
+    std::copy(data.constBegin(), data.constEnd(), mData.end()-n); // pure appends leave the existing part of the value range index valid
+    if (size() > n && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
       std::inplace_merge(begin(), end()-n, end(), qcpLessThanSortKey<DataType>);
   }
+  enforceFixedCapacity();
 }
 
 /*!
@@ -2703,6 +2955,7 @@ void QCPDataContainer<DataType>::add(const QCPDataContainer<DataType> &data)
 template <class DataType>
 void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool alreadySorted)
 {
+  ++mRevision;
   if (data.isEmpty())
     return;
   if (isEmpty())
@@ -2722,13 +2975,16 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
     std::copy(data.constBegin(), data.constEnd(), begin());
   } else // don't need to prepend, so append and then sort and merge if necessary
   {
+    if (mFixedCapacity > 0)
+      prepareFixedCapacityAppend(n, alreadySorted && !qcpLessThanSortKey<DataType>(*data.constBegin(), *(constEnd()-1)));
     mData.resize(mData.size()+n);
-    std::copy(data.constBegin(), data.constEnd(), end()-n);
+    std::copy(data.constBegin(), data.constEnd(), mData.end()-n); // pure appends leave the existing part of the value range index valid
     if (!alreadySorted) // sort appended subrange if it wasn't already sorted
-      std::sort(end()-n, end(), qcpLessThanSortKey<DataType>);
-    if (oldSize > 0 && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
+      std::sort(mData.end()-n, mData.end(), qcpLessThanSortKey<DataType>);
+    if (size() > n && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
       std::inplace_merge(begin(), end()-n, end(), qcpLessThanSortKey<DataType>);
   }
+  enforceFixedCapacity();
 }
 
 /*! \overload
@@ -2740,8 +2996,11 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
 template <class DataType>
 void QCPDataContainer<DataType>::add(const DataType &data)
 {
+  ++mRevision;
   if (isEmpty() || !qcpLessThanSortKey<DataType>(data, *(constEnd()-1))) // quickly handle appends if new data key is greater or equal to existing ones
   {
+    if (mFixedCapacity > 0)
+      prepareFixedCapacityAppend(1, true);
     mData.append(data);
   } else if (qcpLessThanSortKey<DataType>(data, *constBegin()))  // quickly handle prepends using preallocated space
   {
@@ -2751,9 +3010,11 @@ void QCPDataContainer<DataType>::add(const DataType &data)
     *begin() = data;
   } else // handle inserts, maintaining sorted keys
   {
-    QCPDataContainer<DataType>::iterator insertionPoint = std::lower_bound(begin(), end(), data, qcpLessThanSortKey<DataType>);
-    mData.insert(insertionPoint, data);
+    const int insertionIndex = std::lower_bound(constBegin(), constEnd(), data, qcpLessThanSortKey<DataType>)-mData.constBegin();
+    mData.insert(mData.begin()+insertionIndex, data);
+    invalidateIndex(insertionIndex);
   }
+  enforceFixedCapacity();
 }
 
 /*!
@@ -2764,9 +3025,10 @@ void QCPDataContainer<DataType>::add(const DataType &data)
 template <class DataType>
 void QCPDataContainer<DataType>::removeBefore(double sortKey)
 {
-  QCPDataContainer<DataType>::iterator it = begin();
-  QCPDataContainer<DataType>::iterator itEnd = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
-  mPreallocSize += itEnd-it; // don't actually delete, just add it to the preallocated block (if it gets too large, squeeze will take care of it)
+  ++mRevision;
+  QCPDataContainer<DataType>::const_iterator it = constBegin();
+  QCPDataContainer<DataType>::const_iterator itEnd = std::lower_bound(constBegin(), constEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  mPreallocSize += itEnd-it; // don't actually delete, just add it to the preallocated block (if it gets too large, squeeze will take care of it). This also keeps the value range index valid
   if (mAutoSqueeze)
     performAutoSqueeze();
 }
@@ -2779,9 +3041,10 @@ void QCPDataContainer<DataType>::removeBefore(double sortKey)
 template <class DataType>
 void QCPDataContainer<DataType>::removeAfter(double sortKey)
 {
-  QCPDataContainer<DataType>::iterator it = std::upper_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
-  QCPDataContainer<DataType>::iterator itEnd = end();
-  mData.erase(it, itEnd); // typically adds it to the postallocated block
+  ++mRevision;
+  const int removeIndex = std::upper_bound(constBegin(), constEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>)-mData.constBegin();
+  mData.erase(mData.begin()+removeIndex, mData.end()); // typically adds it to the postallocated block
+  invalidateIndex(removeIndex);
   if (mAutoSqueeze)
     performAutoSqueeze();
 }
@@ -2796,12 +3059,15 @@ void QCPDataContainer<DataType>::removeAfter(double sortKey)
 template <class DataType>
 void QCPDataContainer<DataType>::remove(double sortKeyFrom, double sortKeyTo)
 {
+  ++mRevision;
   if (sortKeyFrom >= sortKeyTo || isEmpty())
     return;
   
-  QCPDataContainer<DataType>::iterator it = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKeyFrom), qcpLessThanSortKey<DataType>);
-  QCPDataContainer<DataType>::iterator itEnd = std::upper_bound(it, end(), DataType::fromSortKey(sortKeyTo), qcpLessThanSortKey<DataType>);
-  mData.erase(it, itEnd);
+  QCPDataContainer<DataType>::const_iterator it = std::lower_bound(constBegin(), constEnd(), DataType::fromSortKey(sortKeyFrom), qcpLessThanSortKey<DataType>);
+  QCPDataContainer<DataType>::const_iterator itEnd = std::upper_bound(it, constEnd(), DataType::fromSortKey(sortKeyTo), qcpLessThanSortKey<DataType>);
+  const int removeIndex = it-mData.constBegin();
+  mData.erase(mData.begin()+removeIndex, mData.begin()+(itEnd-mData.constBegin()));
+  invalidateIndex(removeIndex);
   if (mAutoSqueeze)
     performAutoSqueeze();
 }
@@ -2818,13 +3084,18 @@ void QCPDataContainer<DataType>::remove(double sortKeyFrom, double sortKeyTo)
 template <class DataType>
 void QCPDataContainer<DataType>::remove(double sortKey)
 {
-  QCPDataContainer::iterator it = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
-  if (it != end() && it->sortKey() == sortKey)
+  ++mRevision;
+  QCPDataContainer::const_iterator it = std::lower_bound(constBegin(), constEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  if (it != constEnd() && it->sortKey() == sortKey)
   {
-    if (it == begin())
+    if (it == constBegin())
       ++mPreallocSize; // don't actually delete, just add it to the preallocated block (if it gets too large, squeeze will take care of it)
     else
-      mData.erase(it);
+    {
+      const int removeIndex = it-mData.constBegin();
+      mData.erase(mData.begin()+removeIndex);
+      invalidateIndex(removeIndex);
+    }
   }
   if (mAutoSqueeze)
     performAutoSqueeze();
@@ -2838,9 +3109,11 @@ void QCPDataContainer<DataType>::remove(double sortKey)
 template <class DataType>
 void QCPDataContainer<DataType>::clear()
 {
+  ++mRevision;
   mData.clear();
   mPreallocIteration = 0;
   mPreallocSize = 0;
+  invalidateIndex();
 }
 
 /*!
@@ -2868,7 +3141,8 @@ void QCPDataContainer<DataType>::sort()
   applications.
   
   The parameters \a preAllocation and \a postAllocation control whether pre- and/or post allocation
-  should be freed, respectively.
+  should be freed, respectively. If a fixed capacity is set (\ref setFixedCapacity), the storage
+  reserved for it is kept, so \a postAllocation has no effect.
 */
 template <class DataType>
 void QCPDataContainer<DataType>::squeeze(bool preAllocation, bool postAllocation)
@@ -2880,10 +3154,11 @@ void QCPDataContainer<DataType>::squeeze(bool preAllocation, bool postAllocation
       std::copy(begin(), end(), mData.begin());
       mData.resize(size());
       mPreallocSize = 0;
+      invalidateIndex();
     }
     mPreallocIteration = 0;
   }
-  if (postAllocation)
+  if (postAllocation && mFixedCapacity == 0)
     mData.squeeze();
 }
 
@@ -3077,6 +3352,10 @@ QCPRange QCPDataContainer<DataType>::keyRange(bool &foundRange, QCP::SignDomain
   relevant e.g. for logarithmic plots which can mathematically only display one sign domain at a
   time.
 
+  If the value range index is enabled (\ref setValueRangeIndex) and the DataType reports that its
+  main key is equal to the sort key (\a sortKeyIsMainKey), or \a inKeyRange doesn't restrict the
+  keys, the range is determined in logarithmic time with respect to the number of data points.
+
   \see keyRange
 */
 template <class DataType>
@@ -3087,8 +3366,15 @@ QCPRange QCPDataContainer<DataType>::valueRange(bool &foundRange, QCP::SignDomai
     foundRange = false;
     return QCPRange();
   }
-  QCPRange range;
   const bool restrictKeyRange = inKeyRange != QCPRange();
+  if (mValueRangeIndex && (DataType::sortKeyIsMainKey() || !restrictKeyRange))
+  {
+    if (restrictKeyRange) // non-expanded bounds include exactly the data points with keys inside inKeyRange
+      return valueRange(foundRange, findBegin(inKeyRange.lower, false), findEnd(inKeyRange.upper, false), signDomain);
+    else
+      return valueRange(foundRange, constBegin(), constEnd(), signDomain);
+  }
+  QCPRange range;
   bool haveLower = false;
   bool haveUpper = false;
   QCPRange current;
@@ -3159,6 +3445,47 @@ QCPRange QCPDataContainer<DataType>::valueRange(bool &foundRange, QCP::SignDomai
   return range;
 }
 
+/*! \overload
+
+  Returns the range encompassed by the value coordinates of the data points between \a begin
+  (inclusive) and \a end (exclusive), using the full \a DataType::valueRange reported by the data
+  points. The output parameter \a foundRange indicates whether a sensible range was found.
+
+  Use \a signDomain to control which sign of the value coordinates should be considered.
+
+  If the value range index is enabled (\ref setValueRangeIndex), this method only needs to visit a
+  number of index nodes and data points that grows logarithmically with the distance between \a
+  begin and \a end.
+*/
+template <class DataType>
+QCPRange QCPDataContainer<DataType>::valueRange(bool &foundRange, const_iterator begin, const_iterator end, QCP::SignDomain signDomain) const
+{
+  QCPRange range;
+  if (begin == end)
+  {
+    foundRange = false;
+    return range;
+  }
+  const IndexNode summary = summarizeValueRange(begin-mData.constBegin(), end-mData.constBegin());
+  if (signDomain == QCP::sdBoth) // range may be anywhere
+  {
+    range.lower = summary.lower;
+    range.upper = summary.upper;
+  } else if (signDomain == QCP::sdNegative) // range may only be in the negative sign domain
+  {
+    range.lower = summary.lower < 0 ? summary.lower : qQNaN();
+    range.upper = summary.upperNegative;
+  } else if (signDomain == QCP::sdPositive) // range may only be in the positive sign domain
+  {
+    range.lower = summary.lowerPositive;
+    range.upper = summary.upper > 0 ? summary.upper : qQNaN();
+  }
+  foundRange = !qIsNaN(range.lower) && !qIsNaN(range.upper);
+  if (!foundRange)
+    range = QCPRange();
+  return range;
+}
+
 /*!
   Makes sure \a begin and \a end mark a data range that is both within the bounds of this data
   container's data, as well as within the specified \a dataRange. The initial range described by
@@ -3199,6 +3526,7 @@ void QCPDataContainer<DataType>::preallocateGrow(int minimumPreallocSize)
   mData.resize(mData.size()+sizeDifference);
   std::copy_backward(mData.begin()+mPreallocSize, mData.end()-sizeDifference, mData.end());
   mPreallocSize = newPreallocSize;
+  invalidateIndex();
 }
 
 /*! \internal
@@ -3208,7 +3536,8 @@ void QCPDataContainer<DataType>::preallocateGrow(int minimumPreallocSize)
   memory. It then possibly calls \ref squeeze to do the deallocation.
   
   If \ref setAutoSqueeze is enabled, this method is called automatically each time data points are
-  removed from the container (e.g. \ref remove).
+  removed from the container (e.g. \ref remove). It does nothing if a fixed capacity is set (\ref
+  setFixedCapacity).
   
   \note when changing the decision parameters, care must be taken not to cause a back-and-forth
   between squeezing and reallocation due to the growth strategy of the internal QVector and \ref
@@ -3218,6 +3547,8 @@ void QCPDataContainer<DataType>::preallocateGrow(int minimumPreallocSize)
 template <class DataType>
 void QCPDataContainer<DataType>::performAutoSqueeze()
 {
+  if (mFixedCapacity > 0) // storage is managed by the fixed capacity mode
+    return;
   const int totalAlloc = mData.capacity();
   const int postAllocSize = totalAlloc-mData.size();
   const int usedSize = size();
@@ -3236,80 +3567,918 @@ void QCPDataContainer<DataType>::performAutoSqueeze()
   if (shrinkPreAllocation || shrinkPostAllocation)
     squeeze(shrinkPreAllocation, shrinkPostAllocation);
 }
+
+/*! \internal
+
+  Prepares the storage for appending \a appendCount data points while a fixed capacity is set (\ref
+  setFixedCapacity).
+
+  If \a dropOldest is true, the caller guarantees that the appended data points have keys greater
+  than or equal to the existing ones. The data points that would be pushed out by the appended ones
+  are then dropped beforehand, so they don't need to be moved.
+
+  If the appended data points wouldn't fit into the reserved storage behind the current data, the
+  data is moved to the beginning of the storage.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::prepareFixedCapacityAppend(int appendCount, bool dropOldest)
+{
+  if (dropOldest && size()+appendCount > mFixedCapacity)
+    mPreallocSize += qMin(size(), size()+appendCount-mFixedCapacity);
+  if (mData.size()+appendCount > 2*mFixedCapacity && mPreallocSize > 0)
+  {
+    std::copy(mData.constBegin()+mPreallocSize, mData.constEnd(), mData.begin());
+    mData.resize(size());
+    mPreallocSize = 0;
+    mPreallocIteration = 0;
+    invalidateIndex();
+  }
+}
+
+/*! \internal
+
+  If a fixed capacity is set (\ref setFixedCapacity) and the container holds more data points than
+  allowed, drops the data points with the smallest keys. Like \ref removeBefore, this only moves
+  the begin of the data.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::enforceFixedCapacity()
+{
+  if (mFixedCapacity > 0 && size() > mFixedCapacity)
+  {
+    mPreallocSize += size()-mFixedCapacity;
+    ++mRevision;
+  }
+}
+
+/*! \internal
+
+  Brings the value range index up to date with the data, see \ref setValueRangeIndex.
+
+  The index consists of multiple levels. Each node of the lowest level summarizes the value ranges
+  of \c indexBlockSize consecutive data points, and each node of a higher level summarizes \c
+  indexFanout nodes of the level below. The nodes are aligned to the indices of \a mData (including
+  the preallocation pool), so removing data points from the front doesn't shift the nodes.
+
+  Only the nodes covering storage indices starting at \a mIndexedSize are recalculated. Modifying
+  methods make sure to lower \a mIndexedSize to the first storage index they changed, via \ref
+  invalidateIndex.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::updateIndex() const
+{
+  const int storageSize = mData.size();
+  if (mIndexedSize == storageSize && (storageSize == 0 || !mIndexLevels.isEmpty()))
+    return;
+  
+  // lowest level, summarizing the data points:
+  int firstNode = qMin(mIndexedSize, storageSize)/indexBlockSize;
+  int nodeCount = (storageSize+indexBlockSize-1)/indexBlockSize;
+  if (mIndexLevels.isEmpty())
+  {
+    mIndexLevels.resize(1);
+    firstNode = 0;
+  }
+  QVector<IndexNode> &blockNodes = mIndexLevels[0];
+  blockNodes.resize(nodeCount);
+  for (int i=firstNode; i<nodeCount; ++i)
+  {
+    IndexNode node = emptyIndexNode();
+    const int blockEnd = qMin(storageSize, (i+1)*indexBlockSize);
+    for (int k=i*indexBlockSize; k<blockEnd; ++k)
+      expandIndexNode(node, mData.at(k).valueRange());
+    blockNodes[i] = node;
+  }
+  
+  // higher levels, summarizing the nodes of the respective level below, until a single node remains:
+  int level = 1;
+  while (nodeCount > 1)
+  {
+    const int lowerNodeCount = nodeCount;
+    firstNode /= indexFanout;
+    nodeCount = (lowerNodeCount+indexFanout-1)/indexFanout;
+    if (mIndexLevels.size() <= level)
+    {
+      mIndexLevels.resize(level+1);
+      firstNode = 0;
+    }
+    const QVector<IndexNode> &lowerNodes = mIndexLevels.at(level-1);
+    QVector<IndexNode> &nodes = mIndexLevels[level];
+    nodes.resize(nodeCount);
+    for (int i=firstNode; i<nodeCount; ++i)
+    {
+      IndexNode node = emptyIndexNode();
+      const int childEnd = qMin(lowerNodeCount, (i+1)*indexFanout);
+      for (int k=i*indexFanout; k<childEnd; ++k)
+        expandIndexNode(node, lowerNodes.at(k));
+      nodes[i] = node;
+    }
+    ++level;
+  }
+  mIndexLevels.resize(level); // remove levels that became obsolete by a decreased data size
+  mIndexedSize = storageSize;
+}
+
+/*! \internal
+
+  Returns the summary of the value ranges of the data points with storage indices (i.e. indices of
+  \a mData, including the preallocation pool) from \a storageBegin to \a storageEnd (exclusive).
+
+  If the value range index is enabled and the requested range is large enough to benefit from it,
+  the data points at the unaligned borders of the range are visited individually, while the
+  remaining part is assembled from the largest index nodes that fit inside the range. Otherwise
+  all data points in the range are visited.
+*/
+template <class DataType>
+typename QCPDataContainer<DataType>::IndexNode QCPDataContainer<DataType>::summarizeValueRange(int storageBegin, int storageEnd) const
+{
+  IndexNode result = emptyIndexNode();
+  int lower = storageBegin;
+  int upper = storageEnd;
+  if (mValueRangeIndex && upper-lower >= 4*indexBlockSize)
+  {
+    updateIndex();
+    while (lower < upper && lower % indexBlockSize != 0)
+      expandIndexNode(result, mData.at(lower++).valueRange());
+    while (upper > lower && upper % indexBlockSize != 0)
+      expandIndexNode(result, mData.at(--upper).valueRange());
+    lower /= indexBlockSize;
+    upper /= indexBlockSize;
+    int level = 0;
+    while (lower < upper) // each iteration consumes the unaligned border nodes of a level and moves up to the next level
+    {
+      const QVector<IndexNode> &nodes = mIndexLevels.at(level);
+      while (lower < upper && lower % indexFanout != 0)
+        expandIndexNode(result, nodes.at(lower++));
+      while (upper > lower && upper % indexFanout != 0)
+        expandIndexNode(result, nodes.at(--upper));
+      lower /= indexFanout;
+      upper /= indexFanout;
+      ++level;
+    }
+  } else
+  {
+    for (int i=lower; i<upper; ++i)
+      expandIndexNode(result, mData.at(i).valueRange());
+  }
+  return result;
+}
+
+/*! \internal
+
+  Returns an index node that doesn't contain any value range yet, i.e. all members are NaN.
+*/
+template <class DataType>
+typename QCPDataContainer<DataType>::IndexNode QCPDataContainer<DataType>::emptyIndexNode()
+{
+  IndexNode result;
+  result.lower = result.upper = result.lowerPositive = result.upperNegative = qQNaN();
+  return result;
+}
+
+/*! \internal
+
+  Expands the index \a node such that it includes \a range. NaN boundaries of \a range are
+  ignored.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::expandIndexNode(IndexNode &node, const QCPRange &range)
+{
+  if (!qIsNaN(range.lower))
+  {
+    if (range.lower < node.lower || qIsNaN(node.lower))
+      node.lower = range.lower;
+    if (range.lower > 0 && (range.lower < node.lowerPositive || qIsNaN(node.lowerPositive)))
+      node.lowerPositive = range.lower;
+  }
+  if (!qIsNaN(range.upper))
+  {
+    if (range.upper > node.upper || qIsNaN(node.upper))
+      node.upper = range.upper;
+    if (range.upper < 0 && (range.upper > node.upperNegative || qIsNaN(node.upperNegative)))
+      node.upperNegative = range.upper;
+  }
+}
+
+/*! \internal \overload
+
+  Expands the index \a node such that it includes the value ranges summarized by \a other.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::expandIndexNode(IndexNode &node, const IndexNode &other)
+{
+  if (other.lower < node.lower || qIsNaN(node.lower))
+    node.lower = other.lower;
+  if (other.upper > node.upper || qIsNaN(node.upper))
+    node.upper = other.upper;
+  if (other.lowerPositive < node.lowerPositive || qIsNaN(node.lowerPositive))
+    node.lowerPositive = other.lowerPositive;
+  if (other.upperNegative > node.upperNegative || qIsNaN(node.upperNegative))
+    node.upperNegative = other.upperNegative;
+}
 /* end of 'src/datacontainer.cpp' */
 
 
 /* end of 'src/datacontainer.h' */
 
 
-/* including file 'src/plottable.h', size 8433                               */
-/* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
-
-class QCP_LIB_DECL QCPSelectionDecorator
+class QCP_LIB_DECL QCPDataColumn
 {
-  Q_GADGET
 public:
-  QCPSelectionDecorator();
-  virtual ~QCPSelectionDecorator();
+  QCPDataColumn();
+  virtual ~QCPDataColumn();
   
   // getters:
-  QPen pen() const { return mPen; }
-  QBrush brush() const { return mBrush; }
-  QCPScatterStyle scatterStyle() const { return mScatterStyle; }
-  QCPScatterStyle::ScatterProperties usedScatterProperties() const { return mUsedScatterProperties; }
+  int size() const { return mSize; }
+  bool isEmpty() const { return mSize == 0; }
+  const double *constData() const { return mConstData; }
+  inline double at(int index) const { return mConstData ? mConstData[index] : valueAt(index); }
+  uint revision() const { return mRevision; }
   
-  // setters:
-  void setPen(const QPen &pen);
-  void setBrush(const QBrush &brush);
-  void setScatterStyle(const QCPScatterStyle &scatterStyle, QCPScatterStyle::ScatterProperties usedProperties=QCPScatterStyle::spPen);
-  void setUsedScatterProperties(const QCPScatterStyle::ScatterProperties &properties);
+  // introduced virtual methods:
+  virtual int lowerBound(double value, int begin, int end) const;
+  virtual int upperBound(double value, int begin, int end) const;
+  virtual QCPRange range(bool &foundRange, int begin, int end, QCP::SignDomain signDomain=QCP::sdBoth) const;
+  virtual bool hasConstantTimeSearch() const { return false; }
   
   // non-virtual methods:
-  void applyPen(QCPPainter *painter) const;
-  void applyBrush(QCPPainter *painter) const;
-  QCPScatterStyle getFinalScatterStyle(const QCPScatterStyle &unselectedStyle) const;
-  
-  // introduced virtual methods:
-  virtual void copyFrom(const QCPSelectionDecorator *other);
-  virtual void drawDecoration(QCPPainter *painter, QCPDataSelection selection);
+  int cachedLowerBound(double value, uint cacheSerial) const;
+  int cachedUpperBound(double value, uint cacheSerial) const;
+  void markChanged();
   
 protected:
+  struct SearchCacheEntry
+  {
+    uint serial; // 0 marks an unused entry
+    bool upper;
+    double value;
+    int size;
+    int result;
+  };
+  enum { searchCacheSize = 4 };
+  
   // property members:
-  QPen mPen;
-  QBrush mBrush;
-  QCPScatterStyle mScatterStyle;
-  QCPScatterStyle::ScatterProperties mUsedScatterProperties;
+  int mSize;
+  const double *mConstData;
+  
   // non-property members:
-  QCPAbstractPlottable *mPlottable;
+  mutable SearchCacheEntry mSearchCache[searchCacheSize];
+  mutable int mSearchCacheNext;
+  uint mRevision;
   
   // introduced virtual methods:
-  virtual bool registerWithPlottable(QCPAbstractPlottable *plottable);
+  virtual double valueAt(int index) const = 0;
+  
+  // non-virtual methods:
+  int cachedSearch(double value, bool upper, uint cacheSerial) const;
+  void clearSearchCache();
   
 private:
-  Q_DISABLE_COPY(QCPSelectionDecorator)
-  friend class QCPAbstractPlottable;
+  Q_DISABLE_COPY(QCPDataColumn)
 };
-Q_DECLARE_METATYPE(QCPSelectionDecorator*)
 
 
-class QCP_LIB_DECL QCPAbstractPlottable : public QCPLayerable
+class QCP_LIB_DECL QCPDoubleColumn : public QCPDataColumn
 {
-  Q_OBJECT
-  /// \cond INCLUDE_QPROPERTIES
-  Q_PROPERTY(QString name READ name WRITE setName)
-  Q_PROPERTY(bool antialiasedFill READ antialiasedFill WRITE setAntialiasedFill)
-  Q_PROPERTY(bool antialiasedScatters READ antialiasedScatters WRITE setAntialiasedScatters)
-  Q_PROPERTY(QPen pen READ pen WRITE setPen)
-  Q_PROPERTY(QBrush brush READ brush WRITE setBrush)
-  Q_PROPERTY(QCPAxis* keyAxis READ keyAxis WRITE setKeyAxis)
-  Q_PROPERTY(QCPAxis* valueAxis READ valueAxis WRITE setValueAxis)
-  Q_PROPERTY(QCP::SelectionType selectable READ selectable WRITE setSelectable NOTIFY selectableChanged)
-  Q_PROPERTY(QCPDataSelection selection READ selection WRITE setSelection NOTIFY selectionChanged)
-  Q_PROPERTY(QCPSelectionDecorator* selectionDecorator READ selectionDecorator WRITE setSelectionDecorator)
-  /// \endcond
 public:
-  QCPAbstractPlottable(QCPAxis *keyAxis, QCPAxis *valueAxis);
-  virtual ~QCPAbstractPlottable();
+  QCPDoubleColumn();
+  explicit QCPDoubleColumn(const QVector<double> &data);
+  virtual ~QCPDoubleColumn();
+  
+  // getters:
+  QVector<double> data() const { return mData; }
+  
+  // setters:
+  void setData(const QVector<double> &data);
+  
+  // non-property methods:
+  void add(const QVector<double> &data);
+  void add(double value);
+  void clear();
+  
+protected:
+  // property members:
+  QVector<double> mData;
+  
+  // reimplemented virtual methods:
+  virtual double valueAt(int index) const Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  void updateDataView();
+};
+
+
+class QCP_LIB_DECL QCPBufferColumn : public QCPDataColumn
+{
+public:
+  QCPBufferColumn();
+  QCPBufferColumn(const double *data, int size);
+  template <class Owner> QCPBufferColumn(const double *data, int size, const Owner &owner);
+  virtual ~QCPBufferColumn();
+  
+  // setters:
+  void setBuffer(const double *data, int size);
+  template <class Owner> void setBuffer(const double *data, int size, const Owner &owner);
+  
+protected:
+  // type erasure for the lifetime handle of the adopted buffer:
+  class AbstractOwner
+  {
+  public:
+    virtual ~AbstractOwner() {}
+  };
+  template <class Owner>
+  class OwnerHolder : public AbstractOwner
+  {
+  public:
+    explicit OwnerHolder(const Owner &owner) : mOwner(owner) {}
+    Owner mOwner;
+  };
+  
+  // property members:
+  AbstractOwner *mOwner;
+  
+  // reimplemented virtual methods:
+  virtual double valueAt(int index) const Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  void adoptBuffer(const double *data, int size, AbstractOwner *owner);
+};
+
+
+class QCP_LIB_DECL QCPUniformColumn : public QCPDataColumn
+{
+public:
+  QCPUniformColumn();
+  QCPUniformColumn(double start, double step, int size);
+  virtual ~QCPUniformColumn();
+  
+  // getters:
+  double start() const { return mStart; }
+  double step() const { return mStep; }
+  
+  // setters:
+  void setStart(double start);
+  void setStep(double step);
+  void setSize(int size);
+  
+  // reimplemented virtual methods:
+  virtual int lowerBound(double value, int begin, int end) const Q_DECL_OVERRIDE;
+  virtual int upperBound(double value, int begin, int end) const Q_DECL_OVERRIDE;
+  virtual QCPRange range(bool &foundRange, int begin, int end, QCP::SignDomain signDomain=QCP::sdBoth) const Q_DECL_OVERRIDE;
+  virtual bool hasConstantTimeSearch() const Q_DECL_OVERRIDE { return mStep > 0; }
+  
+protected:
+  // property members:
+  double mStart, mStep;
+  
+  // reimplemented virtual methods:
+  virtual double valueAt(int index) const Q_DECL_OVERRIDE { return mStart+index*mStep; }
+  
+  // non-virtual methods:
+  int estimateIndex(double value, int begin, int end) const;
+};
+
+template <class Owner>
+QCPBufferColumn::QCPBufferColumn(const double *data, int size, const Owner &owner) :
+  mOwner(0)
+{
+  adoptBuffer(data, size, new OwnerHolder<Owner>(owner));
+}
+
+template <class Owner>
+void QCPBufferColumn::setBuffer(const double *data, int size, const Owner &owner)
+{
+  adoptBuffer(data, size, new OwnerHolder<Owner>(owner));
+}
+
+template <class SampleType>
+class QCPScaledColumn : public QCPDataColumn // no QCP_LIB_DECL, template class ends up in header
+{
+public:
+  QCPScaledColumn();
+  explicit QCPScaledColumn(const QVector<SampleType> &samples, double scale=1.0, double offset=0.0);
+  virtual ~QCPScaledColumn();
+  
+  // getters:
+  QVector<SampleType> samples() const { return mSamples; }
+  double scale() const { return mScale; }
+  double offset() const { return mOffset; }
+  
+  // setters:
+  void setSamples(const QVector<SampleType> &samples);
+  void setScale(double scale);
+  void setOffset(double offset);
+  
+  // non-property methods:
+  void add(const QVector<SampleType> &samples);
+  void add(SampleType sample);
+  void clear();
+  
+  // reimplemented virtual methods:
+  virtual QCPRange range(bool &foundRange, int begin, int end, QCP::SignDomain signDomain=QCP::sdBoth) const Q_DECL_OVERRIDE;
+  
+protected:
+  // property members:
+  QVector<SampleType> mSamples;
+  double mScale, mOffset;
+  
+  // reimplemented virtual methods:
+  virtual double valueAt(int index) const Q_DECL_OVERRIDE { return mSamples.constData()[index]*mScale+mOffset; }
+  
+  // non-virtual methods:
+  void updateDataView();
+};
+
+typedef QCPScaledColumn<float> QCPFloatColumn;
+typedef QCPScaledColumn<qint16> QCPInt16Column;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPScaledColumn
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPScaledColumn
+  \brief A data column that stores its samples in a narrower type than double
+  
+  This class template holds the samples of a column in a QVector of \a SampleType, e.g. float or
+  qint16, and converts them to double only when they are accessed. The value of a sample is
+  calculated as
+  \code
+  sample * scale + offset
+  \endcode
+  where \a scale and \a offset are set with \ref setScale and \ref setOffset. This allows raw
+  acquisition data such as the counts of a 16 bit analog-to-digital converter to be displayed in
+  physical units without converting the entire data set to double. Compared to a \ref
+  QCPDoubleColumn, a float column uses half and a qint16 column a quarter of the memory.
+  
+  When a QCPGraph displays such a column (see \ref
+  QCPGraph::setData(QSharedPointer<QCPDataColumn>, QSharedPointer<QCPDataColumn>)), the drawing,
+  adaptive sampling and selection paths only convert the samples they actually visit. The extremes
+  returned by \ref range are determined on the raw samples, and only the two resulting extremes
+  are converted.
+  
+  The convenience typedefs \ref QCPFloatColumn and \ref QCPInt16Column cover the most common
+  sample types. Other arithmetic types can be used by instantiating the template directly.
+  
+  When this column is used as key column of a \ref QCPGraphColumnData, the converted samples must
+  be sorted in ascending order. This requires the raw samples to be sorted ascendingly and the
+  scale to be positive.
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn QVector<SampleType> QCPScaledColumn::samples() const
+  
+  Returns the raw, unscaled samples of this column. Since QVector is implicitly shared, this
+  doesn't copy the samples.
+*/
+
+/*! \fn double QCPScaledColumn::scale() const
+  
+  Returns the factor the raw samples are multiplied with. See \ref setScale.
+*/
+
+/*! \fn double QCPScaledColumn::offset() const
+  
+  Returns the offset that is added to the scaled samples. See \ref setOffset.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs an empty column with a scale of 1 and an offset of 0.
+*/
+template <class SampleType>
+QCPScaledColumn<SampleType>::QCPScaledColumn() :
+  mScale(1.0),
+  mOffset(0.0)
+{
+}
+
+/*!
+  Constructs a column holding the raw \a samples, which are converted with \a scale and \a offset
+  when accessed.
+*/
+template <class SampleType>
+QCPScaledColumn<SampleType>::QCPScaledColumn(const QVector<SampleType> &samples, double scale, double offset) :
+  mSamples(samples),
+  mScale(scale),
+  mOffset(offset)
+{
+  updateDataView();
+}
+
+template <class SampleType>
+QCPScaledColumn<SampleType>::~QCPScaledColumn()
+{
+}
+
+/*!
+  Replaces the raw samples of this column with \a samples.
+  
+  \see add, clear
+*/
+template <class SampleType>
+void QCPScaledColumn<SampleType>::setSamples(const QVector<SampleType> &samples)
+{
+  mSamples = samples;
+  updateDataView();
+}
+
+/*!
+  Sets the factor the raw samples are multiplied with when they are converted to double.
+  
+  \see setOffset
+*/
+template <class SampleType>
+void QCPScaledColumn<SampleType>::setScale(double scale)
+{
+  mScale = scale;
+  clearSearchCache();
+}
+
+/*!
+  Sets the offset that is added to the scaled samples when they are converted to double.
+  
+  \see setScale
+*/
+template <class SampleType>
+void QCPScaledColumn<SampleType>::setOffset(double offset)
+{
+  mOffset = offset;
+  clearSearchCache();
+}
+
+/*! \overload
+  
+  Appends the raw \a samples to the end of this column.
+  
+  \see setSamples
+*/
+template <class SampleType>
+void QCPScaledColumn<SampleType>::add(const QVector<SampleType> &samples)
+{
+  mSamples << samples;
+  updateDataView();
+}
+
+/*! \overload
+  
+  Appends the raw \a sample to the end of this column.
+  
+  \see setSamples
+*/
+template <class SampleType>
+void QCPScaledColumn<SampleType>::add(SampleType sample)
+{
+  mSamples.append(sample);
+  updateDataView();
+}
+
+/*!
+  Removes all samples from this column.
+  
+  \see setSamples
+*/
+template <class SampleType>
+void QCPScaledColumn<SampleType>::clear()
+{
+  mSamples.clear();
+  updateDataView();
+}
+
+/*!
+  Returns the range spanned by the converted samples in the index range \a begin to \a end
+  (exclusive), ignoring NaN samples.
+  
+  For \ref QCP::sdBoth, the extremes are searched among the raw samples, and only the two extremes
+  are converted to double. Since the conversion is linear, this yields the same range as
+  converting every sample. For the other sign domains, the sign of each converted sample matters,
+  so the implementation of the base class is used.
+*/
+template <class SampleType>
+QCPRange QCPScaledColumn<SampleType>::range(bool &foundRange, int begin, int end, QCP::SignDomain signDomain) const
+{
+  if (signDomain != QCP::sdBoth)
+    return QCPDataColumn::range(foundRange, begin, end, signDomain);
+  
+  begin = qMax(begin, 0);
+  end = qMin(end, mSize);
+  const SampleType *samples = mSamples.constData();
+  // skip leading NaN samples (the self-comparison is only false for NaN of floating point types):
+  while (begin < end && !(samples[begin] == samples[begin]))
+    ++begin;
+  foundRange = begin < end;
+  if (!foundRange)
+    return QCPRange();
+  
+  SampleType lower = samples[begin];
+  SampleType upper = samples[begin];
+  // comparisons with NaN are always false, so later NaN samples are skipped without extra branches:
+  for (int i=begin+1; i<end; ++i)
+  {
+    const SampleType current = samples[i];
+    if (current < lower)
+      lower = current;
+    if (current > upper)
+      upper = current;
+  }
+  // a negative scale swaps the extremes, which the QCPRange constructor normalizes:
+  return QCPRange(lower*mScale+mOffset, upper*mScale+mOffset);
+}
+
+/*! \internal
+  
+  Updates the size of the base class after \a mSamples was modified. The samples aren't doubles,
+  so the base class accesses them via \ref valueAt.
+*/
+template <class SampleType>
+void QCPScaledColumn<SampleType>::updateDataView()
+{
+  mSize = mSamples.size();
+  mConstData = 0;
+  clearSearchCache();
+}
+
+template <class DataType>
+class QCPDataQueue // no QCP_LIB_DECL, template class ends up in header (cpp included below)
+{
+public:
+  explicit QCPDataQueue(int capacity=65536);
+  ~QCPDataQueue();
+  
+  // getters:
+  int capacity() const { return mSlotCount-1; }
+  
+  // non-property methods:
+  int push(const DataType *data, int count);
+  int push(const QVector<DataType> &data) { return push(data.constData(), data.size()); }
+  bool push(const DataType &data) { return push(&data, 1) == 1; }
+  int pendingCount() const;
+  int takeAll(QVector<DataType> *target);
+  
+protected:
+  // property members:
+  int mSlotCount;
+  DataType *mSlots;
+  
+  // non-property members:
+  QAtomicInt mHead; // slot the producer writes next, only modified by the producer
+  QAtomicInt mTail; // slot the consumer reads next, only modified by the consumer
+  
+  // non-virtual methods:
+  static int loadAcquire(const QAtomicInt &value);
+  static void storeRelease(QAtomicInt &value, int newValue);
+  
+private:
+  Q_DISABLE_COPY(QCPDataQueue)
+};
+
+// include implementation in header since it is a class template:
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPDataQueue
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPDataQueue
+  \brief A lock-free queue that hands data points from an acquisition thread to a plottable
+  
+  Plottables may only be modified in the thread that owns the QCustomPlot, usually the GUI thread.
+  Live data that is acquired in a different thread would therefore have to be passed to the GUI
+  thread (e.g. via queued signals) before it can be added with \ref QCPGraph::addData or similar
+  methods. This queue removes that detour: The acquisition thread pushes data points into the
+  queue directly, and the plottable takes all pending data points at the beginning of the next
+  replot and adds them to its data container in one bulk operation.
+  
+  The queue is a ring buffer of fixed \ref capacity. It supports exactly one producer thread,
+  which calls \ref push, and one consumer, which is the plottable the queue is set on with \ref
+  QCPAbstractPlottable1D::setDataQueue. Neither side ever blocks or locks, the two sides only
+  synchronize via atomic indices of the ring buffer.
+  
+  \code
+  QSharedPointer<QCPDataQueue<QCPGraphData> > queue(new QCPDataQueue<QCPGraphData>(1<<20));
+  graph->setDataQueue(queue);
+  // in the acquisition thread:
+  queue->push(QCPGraphData(timestamp, sample));
+  \endcode
+  
+  The pending data points are only taken when the plot is replotted, so something must still
+  trigger replots periodically, e.g. a QTimer in the GUI thread. If the producer pushes more data
+  points than fit into the queue until the next replot, \ref push only accepts as many as fit and
+  returns that number. The producer may then retry later or drop the remaining data points.
+  
+  The queue is held via QSharedPointer by the plottable and the producer, so it stays valid for
+  the producer even if the plottable is deleted.
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn int QCPDataQueue<DataType>::capacity() const
+  
+  Returns the maximum number of data points that can be pending in this queue.
+*/
+
+/*! \fn int QCPDataQueue<DataType>::push(const QVector<DataType> &data)
+  
+  \overload
+  
+  Appends the data points in \a data to the queue and returns the number of data points that were
+  accepted. If the queue is too full to accept all of them, only the leading data points are
+  accepted.
+  
+  This method may only be called from the producer thread.
+*/
+
+/*! \fn bool QCPDataQueue<DataType>::push(const DataType &data)
+  
+  \overload
+  
+  Appends the single data point \a data to the queue. Returns false if the queue is full and the
+  data point wasn't accepted.
+  
+  This method may only be called from the producer thread.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs an empty queue that can hold up to \a capacity pending data points.
+*/
+template <class DataType>
+QCPDataQueue<DataType>::QCPDataQueue(int capacity) :
+  mSlotCount(qMax(1, capacity)+1), // one slot always stays empty to tell a full from an empty queue
+  mSlots(new DataType[mSlotCount]),
+  mHead(0),
+  mTail(0)
+{
+}
+
+template <class DataType>
+QCPDataQueue<DataType>::~QCPDataQueue()
+{
+  delete[] mSlots;
+}
+
+/*!
+  Appends the \a count data points at \a data to the queue and returns the number of data points
+  that were accepted. If the queue is too full to accept all of them, only the leading data points
+  are accepted.
+  
+  The data points are published to the consumer all at once when this method returns, so a
+  replot never takes a partially written batch.
+  
+  This method may only be called from the producer thread.
+*/
+template <class DataType>
+int QCPDataQueue<DataType>::push(const DataType *data, int count)
+{
+  const int head = loadAcquire(mHead);
+  const int tail = loadAcquire(mTail);
+  const int freeCount = (tail-head-1+mSlotCount) % mSlotCount;
+  const int n = qBound(0, count, freeCount);
+  // copy in at most two contiguous chunks, the second one wraps around to the start of the ring:
+  const int firstChunk = qMin(n, mSlotCount-head);
+  std::copy(data, data+firstChunk, mSlots+head);
+  std::copy(data+firstChunk, data+n, mSlots);
+  storeRelease(mHead, (head+n) % mSlotCount);
+  return n;
+}
+
+/*!
+  Returns the number of data points that were pushed but not yet taken. If the producer is pushing
+  concurrently, the returned number is a snapshot.
+*/
+template <class DataType>
+int QCPDataQueue<DataType>::pendingCount() const
+{
+  return (loadAcquire(mHead)-loadAcquire(mTail)+mSlotCount) % mSlotCount;
+}
+
+/*!
+  Appends all pending data points to \a target, removes them from the queue and returns their
+  number. Data points that the producer pushes concurrently are either taken completely or left
+  for the next call.
+  
+  This method may only be called from the consumer thread. It is called by \ref
+  QCPAbstractPlottable1D at the beginning of each replot.
+*/
+template <class DataType>
+int QCPDataQueue<DataType>::takeAll(QVector<DataType> *target)
+{
+  const int head = loadAcquire(mHead);
+  const int tail = loadAcquire(mTail);
+  const int n = (head-tail+mSlotCount) % mSlotCount;
+  if (n == 0 || !target)
+    return 0;
+  
+  const int oldSize = target->size();
+  target->resize(oldSize+n);
+  const int firstChunk = qMin(n, mSlotCount-tail);
+  std::copy(mSlots+tail, mSlots+tail+firstChunk, target->begin()+oldSize);
+  std::copy(mSlots, mSlots+n-firstChunk, target->begin()+oldSize+firstChunk);
+  storeRelease(mTail, head);
+  return n;
+}
+
+/*! \internal
+  
+  Returns the current value of the atomic index \a value with acquire semantics, i.e. the data
+  points the other thread wrote before publishing this index are visible afterwards.
+*/
+template <class DataType>
+int QCPDataQueue<DataType>::loadAcquire(const QAtomicInt &value)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+  return const_cast<QAtomicInt&>(value).fetchAndAddAcquire(0);
+#else
+  return value.loadAcquire();
+#endif
+}
+
+/*! \internal
+  
+  Sets the atomic index \a value to \a newValue with release semantics, i.e. all slots written or
+  read before become visible to the other thread together with the new index.
+*/
+template <class DataType>
+void QCPDataQueue<DataType>::storeRelease(QAtomicInt &value, int newValue)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+  value.fetchAndStoreRelease(newValue);
+#else
+  value.storeRelease(newValue);
+#endif
+}
+
+
+/* including file 'src/plottable.h', size 8433                               */
+/* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
+
+class QCP_LIB_DECL QCPSelectionDecorator
+{
+  Q_GADGET
+public:
+  QCPSelectionDecorator();
+  virtual ~QCPSelectionDecorator();
+  
+  // getters:
+  QPen pen() const { return mPen; }
+  QBrush brush() const { return mBrush; }
+  QCPScatterStyle scatterStyle() const { return mScatterStyle; }
+  QCPScatterStyle::ScatterProperties usedScatterProperties() const { return mUsedScatterProperties; }
+  
+  // setters:
+  void setPen(const QPen &pen);
+  void setBrush(const QBrush &brush);
+  void setScatterStyle(const QCPScatterStyle &scatterStyle, QCPScatterStyle::ScatterProperties usedProperties=QCPScatterStyle::spPen);
+  void setUsedScatterProperties(const QCPScatterStyle::ScatterProperties &properties);
+  
+  // non-virtual methods:
+  void applyPen(QCPPainter *painter) const;
+  void applyBrush(QCPPainter *painter) const;
+  QCPScatterStyle getFinalScatterStyle(const QCPScatterStyle &unselectedStyle) const;
+  
+  // introduced virtual methods:
+  virtual void copyFrom(const QCPSelectionDecorator *other);
+  virtual void drawDecoration(QCPPainter *painter, QCPDataSelection selection);
+  
+protected:
+  // property members:
+  QPen mPen;
+  QBrush mBrush;
+  QCPScatterStyle mScatterStyle;
+  QCPScatterStyle::ScatterProperties mUsedScatterProperties;
+  // non-property members:
+  QCPAbstractPlottable *mPlottable;
+  
+  // introduced virtual methods:
+  virtual bool registerWithPlottable(QCPAbstractPlottable *plottable);
+  
+private:
+  Q_DISABLE_COPY(QCPSelectionDecorator)
+  friend class QCPAbstractPlottable;
+};
+Q_DECLARE_METATYPE(QCPSelectionDecorator*)
+
+
+class QCP_LIB_DECL QCPAbstractPlottable : public QCPLayerable
+{
+  Q_OBJECT
+  /// \cond INCLUDE_QPROPERTIES
+  Q_PROPERTY(QString name READ name WRITE setName)
+  Q_PROPERTY(bool antialiasedFill READ antialiasedFill WRITE setAntialiasedFill)
+  Q_PROPERTY(bool antialiasedScatters READ antialiasedScatters WRITE setAntialiasedScatters)
+  Q_PROPERTY(QPen pen READ pen WRITE setPen)
+  Q_PROPERTY(QBrush brush READ brush WRITE setBrush)
+  Q_PROPERTY(QCPAxis* keyAxis READ keyAxis WRITE setKeyAxis)
+  Q_PROPERTY(QCPAxis* valueAxis READ valueAxis WRITE setValueAxis)
+  Q_PROPERTY(QCP::SelectionType selectable READ selectable WRITE setSelectable NOTIFY selectableChanged)
+  Q_PROPERTY(QCPDataSelection selection READ selection WRITE setSelection NOTIFY selectionChanged)
+  Q_PROPERTY(QCPSelectionDecorator* selectionDecorator READ selectionDecorator WRITE setSelectionDecorator)
+  /// \endcond
+public:
+  QCPAbstractPlottable(QCPAxis *keyAxis, QCPAxis *valueAxis);
+  virtual ~QCPAbstractPlottable();
   
   // getters:
   QString name() const { return mName; }
@@ -3336,6 +4505,9 @@ public:
   Q_SLOT void setSelection(QCPDataSelection selection);
   void setSelectionDecorator(QCPSelectionDecorator *decorator);
 
+  // reimplemented virtual methods:
+  virtual void markDirty() Q_DECL_OVERRIDE;
+  
   // introduced virtual methods:
   virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=0) const Q_DECL_OVERRIDE = 0; // actually introduced in QCPLayerable as non-pure, but we want to force reimplementation for plottables
   virtual QCPPlottableInterface1D *interface1D() { return 0; }
@@ -3382,6 +4554,7 @@ protected:
   
   // introduced virtual methods:
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const = 0;
+  virtual void takeQueuedData() {}
   
   // non-virtual methods:
   void applyFillAntialiasingHint(QCPPainter *painter) const;
@@ -3436,6 +4609,7 @@ private:
   Q_DISABLE_COPY(QCPItemAnchor)
   
   friend class QCPItemPosition;
+  friend class QCPAbstractItem;
 };
 
 
@@ -3537,6 +4711,7 @@ public:
   
   // reimplemented virtual methods:
   virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=0) const Q_DECL_OVERRIDE = 0;
+  virtual void markDirty() Q_DECL_OVERRIDE;
   
   // non-virtual methods:
   QList<QCPItemPosition*> positions() const { return mPositions; }
@@ -3625,6 +4800,15 @@ public:
                        };
   Q_ENUMS(RefreshPriority)
   
+  /*!
+    Defines which paint buffer implementation is used for the software rasterizer (see \ref
+    setPaintBufferType). OpenGL paint buffers are used instead, if \ref setOpenGl is enabled.
+  */
+  enum PaintBufferType { pbtPixmap ///< Paint buffers are based on QPixmap (\ref QCPPaintBufferPixmap)
+                         ,pbtImage ///< Paint buffers are based on QImage (\ref QCPPaintBufferImage), which may also be painted on outside the GUI thread
+                       };
+  Q_ENUMS(PaintBufferType)
+  
   explicit QCustomPlot(QWidget *parent = 0);
   virtual ~QCustomPlot();
   
@@ -3646,6 +4830,11 @@ public:
   QCP::SelectionRectMode selectionRectMode() const { return mSelectionRectMode; }
   QCPSelectionRect *selectionRect() const { return mSelectionRect; }
   bool openGl() const { return mOpenGl; }
+  double maximumFrameRate() const { return mMaximumFrameRate; }
+  bool backgroundRendering() const { return mBackgroundRendering; }
+  PaintBufferType paintBufferType() const { return mPaintBufferType; }
+  int replotCount() const { return mReplotCount; }
+  int mergedReplotCount() const { return mMergedReplotCount; }
   
   // setters:
   void setViewport(const QRect &rect);
@@ -3670,8 +4859,12 @@ public:
   void setSelectionRectMode(QCP::SelectionRectMode mode);
   void setSelectionRect(QCPSelectionRect *selectionRect);
   void setOpenGl(bool enabled, int multisampling=16);
+  void setMaximumFrameRate(double framesPerSecond);
+  void setBackgroundRendering(bool enabled);
+  void setPaintBufferType(PaintBufferType type);
   
   // non-property methods:
+  void resetReplotCounters();
   // plottable interface:
   QCPAbstractPlottable *plottable(int index);
   QCPAbstractPlottable *plottable();
@@ -3714,6 +4907,10 @@ public:
   bool addLayer(const QString &name, QCPLayer *otherLayer=0, LayerInsertMode insertMode=limAbove);
   bool removeLayer(QCPLayer *layer);
   bool moveLayer(QCPLayer *layer, QCPLayer *otherLayer, LayerInsertMode insertMode=limAbove);
+  QCPLayer *overlayLayer();
+  bool moveToOverlay(QCPLayerable *layerable);
+  bool moveFromOverlay(QCPLayerable *layerable);
+  void replotOverlay();
   
   // axis rect/layout interface:
   int axisRectCount() const;
@@ -3733,6 +4930,7 @@ public:
   bool saveBmp(const QString &fileName, int width=0, int height=0, double scale=1.0, int resolution=96, QCP::ResolutionUnit resolutionUnit=QCP::ruDotsPerInch);
   bool saveRastered(const QString &fileName, int width, int height, double scale, const char *format, int quality=-1, int resolution=96, QCP::ResolutionUnit resolutionUnit=QCP::ruDotsPerInch);
   QPixmap toPixmap(int width=0, int height=0, double scale=1.0);
+  QImage toImage(int width=0, int height=0, double scale=1.0);
   void toPainter(QCPPainter *painter, int width=0, int height=0);
   Q_SLOT void replot(QCustomPlot::RefreshPriority refreshPriority=QCustomPlot::rpRefreshHint);
   
@@ -3784,9 +4982,13 @@ protected:
   QCP::SelectionRectMode mSelectionRectMode;
   QCPSelectionRect *mSelectionRect;
   bool mOpenGl;
+  double mMaximumFrameRate;
+  bool mBackgroundRendering;
+  PaintBufferType mPaintBufferType;
   
   // non-property members:
   QList<QSharedPointer<QCPAbstractPaintBuffer> > mPaintBuffers;
+  QList<QSharedPointer<QCPAbstractPaintBuffer> > mPaintBufferPool;
   QPoint mMousePressPos;
   bool mMouseHasMoved;
   QPointer<QCPLayerable> mMouseEventLayerable;
@@ -3795,6 +4997,16 @@ protected:
   QVariant mMouseSignalLayerableDetails;
   bool mReplotting;
   bool mReplotQueued;
+  uint mReplotSerial;
+  QVector<double> mFrameSignature;
+  QVector<double> mLayoutSignature;
+  QList<QPair<QPointer<QCPLayerable>, QPointer<QCPLayer> > > mOverlayOrigins;
+  QTimer *mFrameTimer;
+  QElapsedTimer mFrameClock;
+  int mReplotCount, mMergedReplotCount;
+  QThreadPool *mRenderThreadPool;
+  QSharedPointer<QCPPaintBufferRenderTask> mRunningRenderTask, mPendingRenderTask;
+  QRegion mRunningRenderDamage, mPendingRenderDamage;
   int mOpenGlMultisamples;
   QCP::AntialiasedElements mOpenGlAntialiasedElementsBackup;
   bool mOpenGlCacheLabelsBackup;
@@ -3833,8 +5045,22 @@ protected:
   QList<QCPLayerable*> layerableListAt(const QPointF &pos, bool onlySelectable, QList<QVariant> *selectionDetails=0) const;
   void drawBackground(QCPPainter *painter);
   void setupPaintBuffers();
+  void assignPaintBuffer(QCPLayer *layer, const QSharedPointer<QCPAbstractPaintBuffer> &buffer);
+  QVector<double> frameSignature() const;
+  bool updateFrameSignature();
+  QVector<double> layoutSignature();
   QCPAbstractPaintBuffer *createPaintBuffer();
+  QSharedPointer<QCPAbstractPaintBuffer> takePaintBuffer();
   bool hasInvalidatedPaintBuffers();
+  bool renderingInBackground() const;
+  bool usesImagePaintBuffers() const;
+  void recordPaintBuffer(const QSharedPointer<QCPAbstractPaintBuffer> &buffer, QList<QPicture> *pictures, QList<QRect> *rects);
+  void recordPhase(const QList<QCPLayerable*> &layerables, const QList<int> &tiles, const QList<QRect> &tileRects, const QRect &fullRect, QList<QPicture> *pictures, QList<QRect> *rects);
+  QPicture recordLayerables(const QList<QCPLayerable*> &layerables);
+  void queueBackgroundRendering(const QSharedPointer<QCPAbstractPaintBuffer> &buffer);
+  void startBackgroundRendering();
+  void renderInParallel(const QList<QSharedPointer<QCPAbstractPaintBuffer> > &buffers);
+  Q_SLOT void backgroundRenderingFinished();
   bool setupOpenGl();
   void freeOpenGl();
   
@@ -3848,6 +5074,7 @@ protected:
 };
 Q_DECLARE_METATYPE(QCustomPlot::LayerInsertMode)
 Q_DECLARE_METATYPE(QCustomPlot::RefreshPriority)
+Q_DECLARE_METATYPE(QCustomPlot::PaintBufferType)
 
 /* end of 'src/core.h' */
 
@@ -3881,6 +5108,12 @@ public:
   QCPAbstractPlottable1D(QCPAxis *keyAxis, QCPAxis *valueAxis);
   virtual ~QCPAbstractPlottable1D();
   
+  // getters:
+  QSharedPointer<QCPDataQueue<DataType> > dataQueue() const { return mDataQueue; }
+  
+  // setters:
+  void setDataQueue(QSharedPointer<QCPDataQueue<DataType> > queue);
+  
   // virtual methods of 1d plottable interface:
   virtual int dataCount() const Q_DECL_OVERRIDE;
   virtual double dataMainKey(int index) const Q_DECL_OVERRIDE;
@@ -3900,6 +5133,10 @@ public:
 protected:
   // property members:
   QSharedPointer<QCPDataContainer<DataType> > mDataContainer;
+  QSharedPointer<QCPDataQueue<DataType> > mDataQueue;
+  
+  // reimplemented virtual methods:
+  virtual void takeQueuedData() Q_DECL_OVERRIDE;
   
   // helpers for subclasses:
   void getDataSegments(QList<QCPDataRange> &selectedSegments, QList<QCPDataRange> &unselectedSegments) const;
@@ -4112,6 +5349,25 @@ QCPAbstractPlottable1D<DataType>::~QCPAbstractPlottable1D()
 {
 }
 
+/*!
+  Sets the queue from which this plottable takes data points that other threads push (see \ref
+  QCPDataQueue). At the beginning of each replot, all data points pending in \a queue are added to
+  the data container of this plottable in one bulk operation. Pass a null pointer to stop taking
+  data from a queue.
+  
+  This method, like all other methods of the plottable, must be called from the thread that owns
+  the parent plot. Only \ref QCPDataQueue::push may be called from the producer thread.
+  
+  The queued data points always go to the data container. Plottables that can display other data
+  instead, like a \ref QCPGraph with column data (see \ref QCPGraph::setColumnData), don't show
+  them until they display their data container again.
+*/
+template <class DataType>
+void QCPAbstractPlottable1D<DataType>::setDataQueue(QSharedPointer<QCPDataQueue<DataType> > queue)
+{
+  mDataQueue = queue;
+}
+
 /*!
   \copydoc QCPPlottableInterface1D::dataCount
 */
@@ -4344,6 +5600,29 @@ double QCPAbstractPlottable1D<DataType>::selectTest(const QPointF &pos, bool onl
   return qSqrt(minDistSqr);
 }
 
+/* inherits documentation from base class */
+template <class DataType>
+void QCPAbstractPlottable1D<DataType>::takeQueuedData()
+{
+  if (!mDataQueue)
+    return;
+  QVector<DataType> queuedData;
+  if (mDataQueue->takeAll(&queuedData) == 0)
+    return;
+  // producers usually push in key order, which allows the data container to simply append:
+  bool sorted = true;
+  for (int i=1; i<queuedData.size(); ++i)
+  {
+    if (qcpLessThanSortKey<DataType>(queuedData.at(i), queuedData.at(i-1)))
+    {
+      sorted = false;
+      break;
+    }
+  }
+  mDataContainer->add(queuedData, sorted);
+  markDirty();
+}
+
 /*!
   Splits all data into selected and unselected segments and outputs them via \a selectedSegments
   and \a unselectedSegments, respectively.
@@ -5160,6 +6439,45 @@ Q_DECLARE_TYPEINFO(QCPGraphData, Q_PRIMITIVE_TYPE);
 */
 typedef QCPDataContainer<QCPGraphData> QCPGraphDataContainer;
 
+class QCP_LIB_DECL QCPGraphColumnData
+{
+public:
+  QCPGraphColumnData();
+  QCPGraphColumnData(QSharedPointer<QCPDataColumn> keys, QSharedPointer<QCPDataColumn> values);
+  
+  // getters:
+  QSharedPointer<QCPDataColumn> keys() const { return mKeys; }
+  QSharedPointer<QCPDataColumn> values() const { return mValues; }
+  int size() const;
+  bool isEmpty() const { return size() == 0; }
+  inline double key(int index) const { return mKeys->at(index); }
+  inline double value(int index) const { return mValues->at(index); }
+  inline QCPGraphData at(int index) const { return QCPGraphData(mKeys->at(index), mValues->at(index)); }
+  bool hasConstantTimeSearch() const { return mKeys->hasConstantTimeSearch(); }
+  
+  // setters:
+  void setKeys(QSharedPointer<QCPDataColumn> keys);
+  void setValues(QSharedPointer<QCPDataColumn> values);
+  
+  // non-property methods:
+  int findBegin(double sortKey, bool expandedRange=true, uint cacheSerial=0) const;
+  int findEnd(double sortKey, bool expandedRange=true, uint cacheSerial=0) const;
+  int lowerBound(double sortKey, int begin, int end) const { return mKeys->lowerBound(sortKey, begin, end); }
+  QCPRange keyRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth) const;
+  QCPRange valueRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const;
+  QCPRange valueRange(bool &foundRange, int begin, int end, QCP::SignDomain signDomain=QCP::sdBoth) const;
+  void copy(int begin, int end, QCPGraphData *target) const;
+  QCPDataRange dataRange() const { return QCPDataRange(0, size()); }
+  
+  // static methods:
+  static QSharedPointer<QCPGraphColumnData> fromMappedFile(const QString &fileName);
+  
+protected:
+  // property members:
+  QSharedPointer<QCPDataColumn> mKeys;
+  QSharedPointer<QCPDataColumn> mValues;
+};
+
 class QCP_LIB_DECL QCPGraph : public QCPAbstractPlottable1D<QCPGraphData>
 {
   Q_OBJECT
@@ -5169,6 +6487,8 @@ class QCP_LIB_DECL QCPGraph : public QCPAbstractPlottable1D<QCPGraphData>
   Q_PROPERTY(int scatterSkip READ scatterSkip WRITE setScatterSkip)
   Q_PROPERTY(QCPGraph* channelFillGraph READ channelFillGraph WRITE setChannelFillGraph)
   Q_PROPERTY(bool adaptiveSampling READ adaptiveSampling WRITE setAdaptiveSampling)
+  Q_PROPERTY(SamplingMethod samplingMethod READ samplingMethod WRITE setSamplingMethod)
+  Q_PROPERTY(int samplingPointCount READ samplingPointCount WRITE setSamplingPointCount)
   /// \endcond
 public:
   /*!
@@ -5186,25 +6506,43 @@ public:
                  };
   Q_ENUMS(LineStyle)
   
+  /*!
+    Defines how the line points are reduced when adaptive sampling is used (see \ref
+    setAdaptiveSampling). The scatter points are not affected.
+    \see setSamplingMethod
+  */
+  enum SamplingMethod { smMinMax ///< the value extremes of each pixel column are placed at fixed positions inside the column. This is the fastest method, because the extremes are retrieved from the value range index of the data
+                        ,smM4    ///< the first, minimum, maximum and last data point of each pixel column are kept at their original keys, so the rasterized line is pixel-exact. This requires a linear scan over the visible data
+                        ,smLttb  ///< Largest-Triangle-Three-Buckets: the data is reduced to a fixed number of points (see \ref setSamplingPointCount), keeping the point of each bucket that spans the largest triangle with its neighbors. This bounds the vertex count of vector exports while preserving the shape of the data
+                      };
+  Q_ENUMS(SamplingMethod)
+  
   explicit QCPGraph(QCPAxis *keyAxis, QCPAxis *valueAxis);
   virtual ~QCPGraph();
   
   // getters:
   QSharedPointer<QCPGraphDataContainer> data() const { return mDataContainer; }
+  QSharedPointer<QCPGraphColumnData> columnData() const { return mColumnData; }
   LineStyle lineStyle() const { return mLineStyle; }
   QCPScatterStyle scatterStyle() const { return mScatterStyle; }
   int scatterSkip() const { return mScatterSkip; }
   QCPGraph *channelFillGraph() const { return mChannelFillGraph.data(); }
   bool adaptiveSampling() const { return mAdaptiveSampling; }
+  SamplingMethod samplingMethod() const { return mSamplingMethod; }
+  int samplingPointCount() const { return mSamplingPointCount; }
   
   // setters:
   void setData(QSharedPointer<QCPGraphDataContainer> data);
   void setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
+  void setData(QSharedPointer<QCPDataColumn> keys, QSharedPointer<QCPDataColumn> values);
+  void setColumnData(QSharedPointer<QCPGraphColumnData> data);
   void setLineStyle(LineStyle ls);
   void setScatterStyle(const QCPScatterStyle &style);
   void setScatterSkip(int skip);
   void setChannelFillGraph(QCPGraph *targetGraph);
   void setAdaptiveSampling(bool enabled);
+  void setSamplingMethod(SamplingMethod method);
+  void setSamplingPointCount(int count);
   
   // non-property methods:
   void addData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
@@ -5215,13 +6553,34 @@ public:
   virtual QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth) const Q_DECL_OVERRIDE;
   virtual QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const Q_DECL_OVERRIDE;
   
+  // virtual methods of 1d plottable interface:
+  virtual int dataCount() const Q_DECL_OVERRIDE;
+  virtual double dataMainKey(int index) const Q_DECL_OVERRIDE;
+  virtual double dataSortKey(int index) const Q_DECL_OVERRIDE;
+  virtual double dataMainValue(int index) const Q_DECL_OVERRIDE;
+  virtual QCPRange dataValueRange(int index) const Q_DECL_OVERRIDE;
+  virtual QPointF dataPixelPosition(int index) const Q_DECL_OVERRIDE;
+  virtual QCPDataSelection selectTestRect(const QRectF &rect, bool onlySelectable) const Q_DECL_OVERRIDE;
+  virtual int findBegin(double sortKey, bool expandedRange=true) const Q_DECL_OVERRIDE;
+  virtual int findEnd(double sortKey, bool expandedRange=true) const Q_DECL_OVERRIDE;
+  
 protected:
+  enum { minimumSamplingChunkSize = 65536 ///< smallest number of data points per chunk when sampling concurrently (see \ref QCP::phParallelSampling)
+         ,lineDataCacheSize = 4          ///< number of sampled lines kept for reuse in later replots (see \ref sampleLineDataCached)
+       };
+  
   // property members:
   LineStyle mLineStyle;
   QCPScatterStyle mScatterStyle;
   int mScatterSkip;
   QPointer<QCPGraph> mChannelFillGraph;
   bool mAdaptiveSampling;
+  SamplingMethod mSamplingMethod;
+  int mSamplingPointCount;
+  QSharedPointer<QCPGraphColumnData> mColumnData;
+  
+  // non-property members:
+  mutable QList<QPair<QVector<double>, QVector<QCPGraphData> > > mLineDataCache;
   
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
@@ -5237,7 +6596,15 @@ protected:
   virtual void getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const;
   
   // non-virtual methods:
+  template <class DataSource> void sampleLineDataCached(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end, const QVector<double> &dataSignature) const;
+  template <class DataSource> void sampleLineData(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end) const;
+  template <class DataSource> int sampleLineIntervals(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end, int chunkBegin, int chunkEnd, double keyEpsilon, QVector<QPair<int, int> > *intervals) const;
+  template <class DataSource> void sampleLineIntervalsInParallel(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end, double keyEpsilon) const;
+  template <class DataSource> void sampleLineDataLttb(QVector<QCPGraphData> *lineData, const DataSource &source, int begin, int end, int pointCount) const;
+  template <class DataSource> void sampleScatterData(QVector<QCPGraphData> *scatterData, const DataSource &source, int begin, int end) const;
+  QVector<double> lineDataSignature(int begin, int end, const QVector<double> &dataSignature) const;
   void getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin, QCPGraphDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const;
+  void getVisibleDataBounds(int &begin, int &end, const QCPDataRange &rangeRestriction) const;
   void getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const;
   void getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataRange) const;
   QVector<QPointF> dataToLines(const QVector<QCPGraphData> &data) const;
@@ -5256,11 +6623,14 @@ protected:
   int findIndexBelowY(const QVector<QPointF> *data, double y) const;
   int findIndexAboveY(const QVector<QPointF> *data, double y) const;
   double pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer::const_iterator &closestData) const;
+  double pointDistance(const QPointF &pixelPoint, int &closestDataIndex) const;
   
   friend class QCustomPlot;
   friend class QCPLegend;
+  template <class DataSource> friend class QCPGraphSamplingTask;
 };
 Q_DECLARE_METATYPE(QCPGraph::LineStyle)
+Q_DECLARE_METATYPE(QCPGraph::SamplingMethod)
 
 /* end of 'src/plottables/plottable-graph.h' */
 